@@ -0,0 +1,75 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "containers/binary_io.hpp"
+
+#if CONTAINERS_HAS_UIO
+#include <fcntl.h>
+
+/*
+    Reading a file of floats back from the page cache. read_buffer sizes the buffer from the header and
+    reads into uninitialized storage, the stream baseline zero fills a vector first and copies through
+    the stream's own buffer.
+*/
+
+static auto bench_file(std::size_t count) -> std::filesystem::path
+{
+    const auto path = std::filesystem::temp_directory_path() / ("containers_bench_binary_io_" + std::to_string(count) + ".bin");
+    if (not std::filesystem::exists(path))
+    {
+        const int output = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        write_buffer(output, dynamic_buffer<float>(count, 1.0f));
+        ::close(output);
+    }
+    return path;
+};
+
+static void read_buffer_descriptor(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    const auto path = bench_file(count);
+    for (auto _ : state)
+    {
+        const int input = ::open(path.c_str(), O_RDONLY);
+        auto buffer = read_buffer<float>(input);
+        ::close(input);
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+};
+
+static void read_vector_stream(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    const auto path = bench_file(count);
+    for (auto _ : state)
+    {
+        std::ifstream input{ path, std::ios::binary };
+        input.seekg(sizeof(buffer_header));
+        std::vector<float> values(count);
+        input.read(reinterpret_cast<char*>(values.data()), count * sizeof(float));
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+};
+
+static void write_buffer_descriptor(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    const auto path = std::filesystem::temp_directory_path() / "containers_bench_binary_io_write.bin";
+    const dynamic_buffer<float> buffer(count, 1.0f);
+    for (auto _ : state)
+    {
+        const int output = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        write_buffer(output, buffer);
+        ::close(output);
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+    std::filesystem::remove(path);
+};
+
+BENCHMARK(read_buffer_descriptor)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(read_vector_stream)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(write_buffer_descriptor)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+#endif
@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include "containers/bitpacked_buffer.hpp"
+
+/*
+    Values under 2^12, kept as a dynamic_buffer of uint32_t or packed to 12 bits.
+    The scans sum every value, the packed one unpacking a few blocks at a time into a small array on the
+    stack, so at large sizes it reads under half the memory. Random reads pick values in a shuffled order.
+*/
+
+static auto random_values(std::size_t count) -> dynamic_buffer<std::uint32_t>
+{
+    std::mt19937 engine{ 7 };
+    std::uniform_int_distribution<std::uint32_t> distribution{ 0, 4095 };
+    dynamic_buffer<std::uint32_t> values{ uninitialized, count };
+    for (std::uint32_t& value : values)
+    {
+        value = distribution(engine);
+    }
+    return values;
+};
+
+template <std::size_t Width>
+static auto packed_values(const dynamic_buffer<std::uint32_t>& values) -> bitpacked_buffer<Width>
+{
+    const std::span<const std::uint32_t> span{ values.begin(), values.end() };
+    if constexpr (Width == dynamic_width)
+    {
+        return bitpacked_buffer<>{ 12, span };
+    }
+    else
+    {
+        return bitpacked_buffer<Width>{ span };
+    }
+};
+
+static void scan_dynamic_buffer(benchmark::State& state)
+{
+    const auto values = random_values(state.range(0));
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(std::reduce(values.begin(), values.end(), std::uint64_t{ 0 }));
+    }
+    state.SetItemsProcessed(state.iterations() * values.size);
+    state.counters["bytes"] = static_cast<double>(values.size * sizeof(std::uint32_t));
+};
+
+template <std::size_t Width>
+static void scan_bitpacked_buffer(benchmark::State& state)
+{
+    const auto values = random_values(state.range(0));
+    const auto packed = packed_values<Width>(values);
+    std::array<std::uint32_t, 4 * bitpacked_block_size> unpacked;
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (std::size_t first = 0; first < packed.size; first += unpacked.size())
+        {
+            const std::span<std::uint32_t> slice{ unpacked.data(), std::min(unpacked.size(), packed.size - first) };
+            packed.unpack(first, slice);
+            sum = std::reduce(slice.begin(), slice.end(), sum);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * packed.size);
+    state.counters["bytes"] = static_cast<double>(packed.words.size * sizeof(std::uint32_t));
+};
+
+static void random_read_dynamic_buffer(benchmark::State& state)
+{
+    const auto values = random_values(state.range(0));
+    dynamic_buffer<std::uint32_t> order{ uninitialized, values.size };
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), std::mt19937{ 11 });
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (std::uint32_t index : order)
+        {
+            sum += values[index];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size);
+};
+
+template <std::size_t Width>
+static void random_read_bitpacked_buffer(benchmark::State& state)
+{
+    const auto values = random_values(state.range(0));
+    const auto packed = packed_values<Width>(values);
+    dynamic_buffer<std::uint32_t> order{ uninitialized, values.size };
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), std::mt19937{ 11 });
+    for (auto _ : state)
+    {
+        std::uint64_t sum = 0;
+        for (std::uint32_t index : order)
+        {
+            sum += packed[index];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * packed.size);
+};
+
+static void pack_bitpacked_buffer(benchmark::State& state)
+{
+    const auto values = random_values(state.range(0));
+    bitpacked_buffer<12> packed(values.size);
+    for (auto _ : state)
+    {
+        packed.pack(0, std::span<const std::uint32_t>{ values.begin(), values.end() });
+        benchmark::DoNotOptimize(packed.words.data);
+    }
+    state.SetItemsProcessed(state.iterations() * values.size);
+};
+
+BENCHMARK(scan_dynamic_buffer)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(scan_bitpacked_buffer<12>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(scan_bitpacked_buffer<dynamic_width>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(random_read_dynamic_buffer)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(random_read_bitpacked_buffer<12>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(random_read_bitpacked_buffer<dynamic_width>)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
+BENCHMARK(pack_bitpacked_buffer)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "containers/checking.hpp"
+#include "containers/dynamic_buffer.hpp"
+
+/*
+    The cost of each checking policy on an indexed sum, against the same loop over a raw pointer.
+    no_checking should not be told apart from raw, which is what a release build with CONTAINERS_CHECKING=0 gets.
+    indexed_buffer goes through dynamic_buffer::operator[] with whatever policy the build picked.
+*/
+
+static void indexed_raw(benchmark::State& state)
+{
+    const dynamic_buffer<std::uint32_t> buffer(state.range(0), 1u);
+    const std::uint32_t* data = buffer.data;
+    const std::size_t size = buffer.size;
+    for (auto _ : state)
+    {
+        std::uint32_t sum = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            sum += data[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+template <typename Policy>
+static void indexed_policy(benchmark::State& state)
+{
+    const dynamic_buffer<std::uint32_t> buffer(state.range(0), 1u);
+    const std::uint32_t* data = buffer.data;
+    const std::size_t size = buffer.size;
+    for (auto _ : state)
+    {
+        std::uint32_t sum = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            Policy::check(i < size);
+            sum += data[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+static void indexed_buffer(benchmark::State& state)
+{
+    const dynamic_buffer<std::uint32_t> buffer(state.range(0), 1u);
+    const std::size_t size = buffer.size;
+    for (auto _ : state)
+    {
+        std::uint32_t sum = 0;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            sum += buffer[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+BENCHMARK(indexed_raw)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(indexed_policy<no_checking>)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(indexed_policy<assert_checking>)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(indexed_policy<always_checking>)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(indexed_policy<sampled_checking<64>>)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(indexed_buffer)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "containers/chunk_reader.hpp"
+
+#if CONTAINERS_HAS_UNISTD
+/*
+    Reading a 64 MiB file and running a pass over every chunk, either alternating read() with the pass
+    on one thread, or with chunk_reader filling the next chunk while the pass runs.
+    The file comes from the page cache after the first run, so reads cost a kernel copy rather than a disk.
+*/
+
+static constexpr std::size_t file_bytes = std::size_t{ 64 } << 20;
+
+static auto bench_file() -> std::filesystem::path
+{
+    const auto path = std::filesystem::temp_directory_path() / "containers_bench_chunk_reader.bin";
+    if (not std::filesystem::exists(path) or std::filesystem::file_size(path) != file_bytes)
+    {
+        std::vector<char> contents(file_bytes, 1);
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write(contents.data(), contents.size());
+    }
+    return path;
+};
+
+// stands in for parsing, passes times over the chunk.
+static auto process(std::span<const std::byte> chunk, int passes) -> std::uint64_t
+{
+    std::uint64_t hash = 0;
+    for (int pass = 0; pass < passes; ++pass)
+    {
+        for (std::size_t offset = 0; offset + sizeof(std::uint64_t) <= chunk.size(); offset += sizeof(std::uint64_t))
+        {
+            std::uint64_t word;
+            std::memcpy(&word, chunk.data() + offset, sizeof(word));
+            hash = (hash ^ word) * 0x100'0000'01B3;
+        }
+    }
+    return hash;
+};
+
+static void synchronous_read(benchmark::State& state)
+{
+    const std::size_t chunk_size = state.range(0);
+    const int passes = static_cast<int>(state.range(1));
+    const auto path = bench_file();
+    dynamic_buffer<std::byte> chunk{ uninitialized, chunk_size };
+    for (auto _ : state)
+    {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        std::uint64_t hash = 0;
+        for (::ssize_t count = ::read(descriptor, chunk.data, chunk_size); count > 0; count = ::read(descriptor, chunk.data, chunk_size))
+        {
+            hash += process({ chunk.data, static_cast<std::size_t>(count) }, passes);
+        }
+        ::close(descriptor);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(state.iterations() * file_bytes);
+};
+
+static void overlapped_read(benchmark::State& state)
+{
+    const std::size_t chunk_size = state.range(0);
+    const int passes = static_cast<int>(state.range(1));
+    const auto path = bench_file();
+    for (auto _ : state)
+    {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        std::uint64_t hash = 0;
+        {
+            chunk_reader reader{ descriptor, chunk_size, 3 };
+            for (std::span<const std::byte> chunk = reader.next(); not chunk.empty(); chunk = reader.next())
+            {
+                hash += process(chunk, passes);
+            }
+        }
+        ::close(descriptor);
+        benchmark::DoNotOptimize(hash);
+    }
+    state.SetBytesProcessed(state.iterations() * file_bytes);
+};
+
+BENCHMARK(synchronous_read)->ArgsProduct({ { 1 << 16, 1 << 20, 1 << 22 }, { 0, 1, 4 } })->UseRealTime();
+BENCHMARK(overlapped_read)->ArgsProduct({ { 1 << 16, 1 << 20, 1 << 22 }, { 0, 1, 4 } })->UseRealTime();
+#endif
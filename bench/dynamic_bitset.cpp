@@ -0,0 +1,121 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include "containers/dynamic_bitset.hpp"
+
+/*
+    Bitmaps of up to 256 million bits, combined the way the filter pipelines do, against the byte per bit
+    dynamic_buffer<uint8_t> they used before. Rank and select queries go to random positions.
+*/
+
+static auto random_bitset(std::size_t size, unsigned seed) -> dynamic_bitset<>
+{
+    std::mt19937_64 engine{ seed };
+    dynamic_bitset<> bits(size);
+    for (std::uint64_t& word : bits.words)
+    {
+        word = engine();
+    }
+    bits.clear_tail();
+    return bits;
+};
+
+static void and_bytes(benchmark::State& state)
+{
+    const std::size_t size = state.range(0);
+    dynamic_buffer<std::uint8_t> left(size, std::uint8_t{ 1 });
+    const dynamic_buffer<std::uint8_t> right(size, std::uint8_t{ 1 });
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            left[i] &= right[i];
+        }
+        benchmark::DoNotOptimize(left.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * 2);
+};
+
+static void and_bitset(benchmark::State& state)
+{
+    auto left = random_bitset(state.range(0), 1);
+    const auto right = random_bitset(state.range(0), 2);
+    for (auto _ : state)
+    {
+        left &= right;
+        benchmark::DoNotOptimize(left.words.data);
+    }
+    state.SetBytesProcessed(state.iterations() * left.words.size * sizeof(std::uint64_t) * 2);
+};
+
+static void and_not_bitset(benchmark::State& state)
+{
+    const auto left = random_bitset(state.range(0), 1);
+    const auto right = random_bitset(state.range(0), 2);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(and_not(left, right).words.data);
+    }
+    state.SetBytesProcessed(state.iterations() * left.words.size * sizeof(std::uint64_t) * 3);
+};
+
+static void count_bitset(benchmark::State& state)
+{
+    const auto bits = random_bitset(state.range(0), 1);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(bits.count());
+    }
+    state.SetBytesProcessed(state.iterations() * bits.words.size * sizeof(std::uint64_t));
+};
+
+static void find_next_bitset(benchmark::State& state)
+{
+    // one bit in 64 set, so most of the time goes to skipping words.
+    auto bits = random_bitset(state.range(0), 1);
+    bits &= random_bitset(state.range(0), 2);
+    bits &= random_bitset(state.range(0), 3);
+    bits &= random_bitset(state.range(0), 4);
+    bits &= random_bitset(state.range(0), 5);
+    bits &= random_bitset(state.range(0), 6);
+    for (auto _ : state)
+    {
+        std::size_t visited = 0;
+        for (std::size_t i = bits.find_first(); i != bits.npos; i = bits.find_next(i))
+        {
+            ++visited;
+        }
+        benchmark::DoNotOptimize(visited);
+    }
+    state.SetBytesProcessed(state.iterations() * bits.words.size * sizeof(std::uint64_t));
+};
+
+static void rank_bitset(benchmark::State& state)
+{
+    const auto bits = random_bitset(state.range(0), 1);
+    const rank_select_index index{ bits };
+    std::mt19937_64 engine{ 7 };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.rank(engine() % bits.size));
+    }
+};
+
+static void select_bitset(benchmark::State& state)
+{
+    const auto bits = random_bitset(state.range(0), 1);
+    const rank_select_index index{ bits };
+    std::mt19937_64 engine{ 7 };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(index.select(engine() % index.total()));
+    }
+};
+
+BENCHMARK(and_bytes)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
+BENCHMARK(and_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
+BENCHMARK(and_not_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
+BENCHMARK(count_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
+BENCHMARK(find_next_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+BENCHMARK(rank_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
+BENCHMARK(select_bitset)->RangeMultiplier(16)->Range(1 << 16, 1 << 28);
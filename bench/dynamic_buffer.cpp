@@ -0,0 +1,445 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <compare>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "containers/dynamic_buffer.hpp"
+
+/*
+    Each container is driven through the same operations so that dynamic_buffer
+    can be compared against std::vector and a bare std::unique_ptr<T[]>.
+*/
+
+template <typename T>
+auto make_value(std::size_t index) -> T
+{
+    if constexpr (std::same_as<T, std::string>)
+    {
+        return std::string(32, static_cast<char>('a' + index % 26));
+    }
+    else
+    {
+        return static_cast<T>(index);
+    }
+};
+
+template <typename T>
+struct dynamic_buffer_ops
+{
+    using value_type = T;
+    using container = dynamic_buffer<T>;
+
+    static auto make(std::size_t size) -> container
+    {
+        container out(uninitialized, size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            std::construct_at(out.data + i, make_value<T>(i));
+        }
+        return out;
+    };
+    static auto construct(std::size_t size) -> container
+    {
+        return container(size);
+    };
+    static auto copy(const container& other) -> container
+    {
+        return container{ other };
+    };
+    static auto resize(container& buffer, std::size_t size) -> void
+    {
+        buffer.resize(size);
+    };
+    static auto size(const container& buffer) -> std::size_t
+    {
+        return buffer.size;
+    };
+    static auto at(const container& buffer, std::size_t index) -> const T&
+    {
+        return buffer[index];
+    };
+    static auto begin(const container& buffer)
+    {
+        return buffer.begin();
+    };
+    static auto end(const container& buffer)
+    {
+        return buffer.end();
+    };
+    static auto equal(const container& left, const container& right) -> bool
+    {
+        return left == right;
+    };
+    static auto compare(const container& left, const container& right)
+    {
+        return left <=> right;
+    };
+};
+
+template <typename T>
+struct vector_ops
+{
+    using value_type = T;
+    using container = std::vector<T>;
+
+    static auto make(std::size_t size) -> container
+    {
+        container out{};
+        out.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out.push_back(make_value<T>(i));
+        }
+        return out;
+    };
+    static auto construct(std::size_t size) -> container
+    {
+        return container(size);
+    };
+    static auto copy(const container& other) -> container
+    {
+        return container{ other };
+    };
+    static auto resize(container& vector, std::size_t size) -> void
+    {
+        vector.resize(size);
+    };
+    static auto size(const container& vector) -> std::size_t
+    {
+        return vector.size();
+    };
+    static auto at(const container& vector, std::size_t index) -> const T&
+    {
+        return vector[index];
+    };
+    static auto begin(const container& vector)
+    {
+        return vector.begin();
+    };
+    static auto end(const container& vector)
+    {
+        return vector.end();
+    };
+    static auto equal(const container& left, const container& right) -> bool
+    {
+        return left == right;
+    };
+    static auto compare(const container& left, const container& right)
+    {
+        return left <=> right;
+    };
+};
+
+template <typename T>
+struct unique_array
+{
+    std::unique_ptr<T[]> data;
+    std::size_t size = 0;
+};
+
+template <typename T>
+struct unique_ptr_ops
+{
+    using value_type = T;
+    using container = unique_array<T>;
+
+    static auto make(std::size_t size) -> container
+    {
+        container out{ std::make_unique_for_overwrite<T[]>(size), size };
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            out.data[i] = make_value<T>(i);
+        }
+        return out;
+    };
+    static auto construct(std::size_t size) -> container
+    {
+        return container{ std::make_unique<T[]>(size), size };
+    };
+    static auto copy(const container& other) -> container
+    {
+        container out{ std::make_unique_for_overwrite<T[]>(other.size), other.size };
+        std::copy_n(other.data.get(), other.size, out.data.get());
+        return out;
+    };
+    static auto resize(container& array, std::size_t size) -> void
+    {
+        auto data = std::make_unique<T[]>(size);
+        std::move(array.data.get(), array.data.get() + std::min(size, array.size), data.get());
+        array.data = std::move(data);
+        array.size = size;
+    };
+    static auto size(const container& array) -> std::size_t
+    {
+        return array.size;
+    };
+    static auto at(const container& array, std::size_t index) -> const T&
+    {
+        return array.data[index];
+    };
+    static auto begin(const container& array)
+    {
+        return array.data.get();
+    };
+    static auto end(const container& array)
+    {
+        return array.data.get() + array.size;
+    };
+    static auto equal(const container& left, const container& right) -> bool
+    {
+        return std::equal(begin(left), end(left), begin(right), end(right));
+    };
+    static auto compare(const container& left, const container& right)
+    {
+        return std::lexicographical_compare_three_way(begin(left), end(left), begin(right), end(right));
+    };
+};
+
+template <typename Ops>
+static void construction(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        auto container = Ops::construct(size);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+};
+
+template <typename Ops>
+static void copy(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto source = Ops::make(size);
+    for (auto _ : state)
+    {
+        auto container = Ops::copy(source);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+};
+
+template <typename Ops>
+static void move(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    auto container = Ops::make(size);
+    for (auto _ : state)
+    {
+        auto other = std::move(container);
+        benchmark::DoNotOptimize(other);
+        container = std::move(other);
+    }
+};
+
+template <typename Ops>
+static void resize(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto container = Ops::make(size);
+        state.ResumeTiming();
+
+        Ops::resize(container, size * 2);
+        benchmark::DoNotOptimize(container);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+};
+
+template <typename Ops>
+static void subscript_scan(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto container = Ops::make(size);
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < Ops::size(container); ++i)
+        {
+            benchmark::DoNotOptimize(Ops::at(container, i));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+};
+
+template <typename Ops>
+static void iterator_scan(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto container = Ops::make(size);
+    for (auto _ : state)
+    {
+        for (auto itr = Ops::begin(container); itr != Ops::end(container); ++itr)
+        {
+            benchmark::DoNotOptimize(*itr);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+};
+
+template <typename Ops>
+static void equality(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto left = Ops::make(size);
+    const auto right = Ops::copy(left);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Ops::equal(left, right));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(typename Ops::value_type));
+};
+
+template <typename Ops>
+static void three_way(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const auto left = Ops::make(size);
+    const auto right = Ops::copy(left);
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(Ops::compare(left, right));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(typename Ops::value_type));
+};
+
+static void sizes(benchmark::internal::Benchmark* benchmark)
+{
+    benchmark->RangeMultiplier(32)->Range(1 << 4, 1 << 20);
+};
+
+#define CONTAINERS_BENCHMARK(ops)                           \
+    BENCHMARK_TEMPLATE(construction, ops)->Apply(sizes);    \
+    BENCHMARK_TEMPLATE(copy, ops)->Apply(sizes);            \
+    BENCHMARK_TEMPLATE(move, ops)->Apply(sizes);            \
+    BENCHMARK_TEMPLATE(resize, ops)->Apply(sizes);          \
+    BENCHMARK_TEMPLATE(subscript_scan, ops)->Apply(sizes);  \
+    BENCHMARK_TEMPLATE(iterator_scan, ops)->Apply(sizes);   \
+    BENCHMARK_TEMPLATE(equality, ops)->Apply(sizes);        \
+    BENCHMARK_TEMPLATE(three_way, ops)->Apply(sizes)
+
+CONTAINERS_BENCHMARK(dynamic_buffer_ops<std::uint8_t>);
+CONTAINERS_BENCHMARK(vector_ops<std::uint8_t>);
+CONTAINERS_BENCHMARK(unique_ptr_ops<std::uint8_t>);
+
+CONTAINERS_BENCHMARK(dynamic_buffer_ops<int>);
+CONTAINERS_BENCHMARK(vector_ops<int>);
+CONTAINERS_BENCHMARK(unique_ptr_ops<int>);
+
+CONTAINERS_BENCHMARK(dynamic_buffer_ops<double>);
+CONTAINERS_BENCHMARK(vector_ops<double>);
+CONTAINERS_BENCHMARK(unique_ptr_ops<double>);
+
+CONTAINERS_BENCHMARK(dynamic_buffer_ops<std::string>);
+CONTAINERS_BENCHMARK(vector_ops<std::string>);
+CONTAINERS_BENCHMARK(unique_ptr_ops<std::string>);
+
+/*
+    Serial against parallel construction and copy of buffers far larger than the caches,
+    argument 0 is the serial overload and anything else the number of threads.
+*/
+
+static void large_construction(benchmark::State& state)
+{
+    const std::size_t size = std::size_t{ 1 } << 26;
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        dynamic_buffer<double> buffer = threads ? dynamic_buffer<double>{ parallel_t{ threads }, size, 1.0 } : dynamic_buffer<double>(size, 1.0);
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(double));
+};
+
+static void large_copy(benchmark::State& state)
+{
+    const std::size_t size = std::size_t{ 1 } << 26;
+    const auto threads = static_cast<std::size_t>(state.range(0));
+    const dynamic_buffer<double> source{ parallel, size, 1.0 };
+    for (auto _ : state)
+    {
+        dynamic_buffer<double> buffer = threads ? dynamic_buffer<double>{ parallel_t{ threads }, source } : dynamic_buffer<double>{ source };
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(double));
+};
+
+BENCHMARK(large_construction)->Arg(0)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(large_copy)->Arg(0)->Arg(2)->Arg(4)->Arg(8)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/*
+    Filling a buffer from a decoder, here one that writes i * 3 into slot i: zeroing it first and then
+    overwriting every element, against building each element once from a generator,
+    through a construct_iterator, or in place with resize_and_overwrite.
+*/
+
+static void fill_zeroed(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint32_t> buffer(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            buffer[i] = static_cast<std::uint32_t>(i * 3);
+        }
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+static void fill_generated(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint32_t> buffer(from_generator, size, [](std::size_t i) { return static_cast<std::uint32_t>(i * 3); });
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+static void fill_output(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint32_t> buffer(from_output, size, [size](auto out)
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                *out++ = static_cast<std::uint32_t>(i * 3);
+            }
+        });
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+static void fill_overwritten(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint32_t> buffer{};
+        buffer.resize_and_overwrite(size, [](std::uint32_t* data, std::size_t count)
+        {
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                data[i] = static_cast<std::uint32_t>(i * 3);
+            }
+            return count;
+        });
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.SetBytesProcessed(state.iterations() * size * sizeof(std::uint32_t));
+};
+
+BENCHMARK(fill_zeroed)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK(fill_generated)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK(fill_output)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
+BENCHMARK(fill_overwritten)->RangeMultiplier(16)->Range(1 << 10, 1 << 24);
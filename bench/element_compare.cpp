@@ -0,0 +1,103 @@
+#include <benchmark/benchmark.h>
+#include <compare>
+#include <cstdint>
+#include "containers/dynamic_buffer.hpp"
+
+/*
+    The element by element loops that dynamic_buffer's comparisons used to run,
+    kept as the baseline for the vectorized kernels.
+*/
+
+template <typename T>
+static auto scalar_equal(const dynamic_buffer<T>& left, const dynamic_buffer<T>& right) -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < left.size; ++i)
+    {
+        if (left[i] != right[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+};
+
+template <typename T>
+static auto scalar_compare(const dynamic_buffer<T>& left, const dynamic_buffer<T>& right) -> std::partial_ordering
+{
+    const std::size_t limit = std::min(left.size, right.size);
+    for (std::size_t i = 0; i < limit; ++i)
+    {
+        auto value = left[i] <=> right[i];
+        if (value != 0)
+        {
+            return value;
+        }
+    }
+
+    return left.size <=> right.size;
+};
+
+template <typename T>
+static void scalar_equality(benchmark::State& state)
+{
+    const dynamic_buffer<T> left(static_cast<std::size_t>(state.range(0)), T{ 1 });
+    const dynamic_buffer<T> right{ left };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(scalar_equal(left, right));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+};
+
+template <typename T>
+static void kernel_equality(benchmark::State& state)
+{
+    const dynamic_buffer<T> left(static_cast<std::size_t>(state.range(0)), T{ 1 });
+    const dynamic_buffer<T> right{ left };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(left == right);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+};
+
+template <typename T>
+static void scalar_three_way(benchmark::State& state)
+{
+    const dynamic_buffer<T> left(static_cast<std::size_t>(state.range(0)), T{ 1 });
+    const dynamic_buffer<T> right{ left };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(scalar_compare(left, right));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+};
+
+template <typename T>
+static void kernel_three_way(benchmark::State& state)
+{
+    const dynamic_buffer<T> left(static_cast<std::size_t>(state.range(0)), T{ 1 });
+    const dynamic_buffer<T> right{ left };
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(left <=> right);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(T));
+};
+
+#define COMPARE_BENCHMARK(type)                                                      \
+    BENCHMARK_TEMPLATE(scalar_equality, type)->RangeMultiplier(64)->Range(64, 1 << 24);  \
+    BENCHMARK_TEMPLATE(kernel_equality, type)->RangeMultiplier(64)->Range(64, 1 << 24);  \
+    BENCHMARK_TEMPLATE(scalar_three_way, type)->RangeMultiplier(64)->Range(64, 1 << 24); \
+    BENCHMARK_TEMPLATE(kernel_three_way, type)->RangeMultiplier(64)->Range(64, 1 << 24)
+
+COMPARE_BENCHMARK(std::uint8_t);
+COMPARE_BENCHMARK(std::uint32_t);
+COMPARE_BENCHMARK(std::int64_t);
+COMPARE_BENCHMARK(double);
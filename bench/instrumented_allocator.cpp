@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "containers/instrumented_allocator.hpp"
+
+/*
+    What the counting costs on the paths it sits on: buffers created and dropped constantly,
+    and a buffer grown one doubling at a time, each with and without instrumentation.
+*/
+
+template <typename A>
+static void churn(benchmark::State& state)
+{
+    const std::size_t size = state.range(0);
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint64_t, A> buffer(uninitialized, size);
+        benchmark::DoNotOptimize(buffer.data);
+    }
+};
+
+template <typename A>
+static void growth(benchmark::State& state)
+{
+    const std::size_t size = state.range(0);
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::uint64_t, A> buffer{};
+        for (std::size_t capacity = 16; capacity <= size; capacity *= 2)
+        {
+            buffer.resize(capacity);
+        }
+        benchmark::DoNotOptimize(buffer.data);
+    }
+};
+
+BENCHMARK(churn<std::allocator<std::uint64_t>>)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(churn<instrumented_allocator<std::uint64_t>>)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(growth<std::allocator<std::uint64_t>>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
+BENCHMARK(growth<instrumented_allocator<std::uint64_t>>)->RangeMultiplier(16)->Range(1 << 8, 1 << 20);
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+#include "containers/matrix_buffer.hpp"
+
+/*
+    The same transpose and five point stencil kernels over row major, tiled and Z-order matrices.
+    Row major reads one side of a transpose a whole row apart, the others keep both sides nearby.
+*/
+
+template <typename Source, typename Destination>
+static auto transpose(Source source, Destination destination) -> void
+{
+    for (std::size_t row = 0; row < source.extent(0); ++row)
+    {
+        for (std::size_t column = 0; column < source.extent(1); ++column)
+        {
+            destination[column, row] = source[row, column];
+        }
+    }
+};
+
+template <typename Source, typename Destination>
+static auto stencil(Source source, Destination destination) -> void
+{
+    for (std::size_t row = 1; row + 1 < source.extent(0); ++row)
+    {
+        for (std::size_t column = 1; column + 1 < source.extent(1); ++column)
+        {
+            destination[row, column] = 0.2f * (source[row, column] +
+                source[row - 1, column] + source[row + 1, column] +
+                source[row, column - 1] + source[row, column + 1]);
+        }
+    }
+};
+
+/*
+    Walks both matrices a tile at a time, as a blocked kernel would. Only the layout of the storage changes.
+*/
+template <typename Source, typename Destination>
+static auto blocked_transpose(Source source, Destination destination) -> void
+{
+    constexpr std::size_t block = 32;
+    for (std::size_t first_row = 0; first_row < source.extent(0); first_row += block)
+    {
+        for (std::size_t first_column = 0; first_column < source.extent(1); first_column += block)
+        {
+            for (std::size_t row = first_row; row < std::min(first_row + block, source.extent(0)); ++row)
+            {
+                for (std::size_t column = first_column; column < std::min(first_column + block, source.extent(1)); ++column)
+                {
+                    destination[column, row] = source[row, column];
+                }
+            }
+        }
+    }
+};
+
+template <typename Matrix>
+static void transpose_matrix(benchmark::State& state)
+{
+    const std::size_t side = state.range(0);
+    Matrix source(side, side, 1.0f);
+    Matrix destination(side, side, 0.0f);
+    for (auto _ : state)
+    {
+        transpose(std::as_const(source).view(), destination.view());
+        benchmark::DoNotOptimize(destination.storage.data);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * side * side * sizeof(float));
+};
+
+template <typename Matrix>
+static void blocked_transpose_matrix(benchmark::State& state)
+{
+    const std::size_t side = state.range(0);
+    Matrix source(side, side, 1.0f);
+    Matrix destination(side, side, 0.0f);
+    for (auto _ : state)
+    {
+        blocked_transpose(std::as_const(source).view(), destination.view());
+        benchmark::DoNotOptimize(destination.storage.data);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * side * side * sizeof(float));
+};
+
+template <typename Matrix>
+static void stencil_matrix(benchmark::State& state)
+{
+    const std::size_t side = state.range(0);
+    Matrix source(side, side, 1.0f);
+    Matrix destination(side, side, 0.0f);
+    for (auto _ : state)
+    {
+        stencil(std::as_const(source).view(), destination.view());
+        benchmark::DoNotOptimize(destination.storage.data);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * side * side * sizeof(float));
+};
+
+BENCHMARK(transpose_matrix<matrix_buffer<float>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(transpose_matrix<tiled_matrix_buffer<float, 16>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(transpose_matrix<morton_matrix_buffer<float>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(blocked_transpose_matrix<matrix_buffer<float>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(blocked_transpose_matrix<tiled_matrix_buffer<float, 32>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(stencil_matrix<matrix_buffer<float>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(stencil_matrix<tiled_matrix_buffer<float, 16>>)->RangeMultiplier(4)->Range(256, 4096);
+BENCHMARK(stencil_matrix<morton_matrix_buffer<float>>)->RangeMultiplier(4)->Range(256, 4096);
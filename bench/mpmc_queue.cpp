@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "containers/mpmc_queue.hpp"
+#include "mutex_queue.hpp"
+
+/*
+    mpmc_queue against a std::deque behind a mutex, every thread both producing and consuming
+    on one shared queue, from a single thread up to eight.
+*/
+
+template <typename Queue>
+static void contention(benchmark::State& state)
+{
+    static Queue queue(1024);
+    std::uint64_t value = static_cast<std::uint64_t>(state.thread_index());
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            while (not queue.try_push(value)) {}
+            while (not queue.try_pop(value)) {}
+        }
+    }
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations() * 64);
+};
+
+static void contention_blocking(benchmark::State& state)
+{
+    static mpmc_queue<std::uint64_t> queue(1024);
+    std::uint64_t value = static_cast<std::uint64_t>(state.thread_index());
+    for (auto _ : state)
+    {
+        for (int i = 0; i < 64; ++i)
+        {
+            queue.push(value);
+            value = queue.pop();
+        }
+    }
+    benchmark::DoNotOptimize(value);
+    state.SetItemsProcessed(state.iterations() * 64);
+};
+
+BENCHMARK_TEMPLATE(contention, mpmc_queue<std::uint64_t>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(contention, mutex_queue<std::uint64_t>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(contention_blocking)->ThreadRange(1, 8)->UseRealTime();
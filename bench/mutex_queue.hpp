@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/*
+    The baseline the lock free queues are measured against.
+*/
+
+template <typename T>
+struct mutex_queue
+{
+    std::mutex mutex;
+    std::deque<T> queue;
+    std::size_t capacity;
+
+    explicit mutex_queue(std::size_t capacity) : capacity{ capacity } {};
+
+    auto try_push(const T& value) -> bool
+    {
+        std::lock_guard lock{ mutex };
+        if (queue.size() == capacity)
+        {
+            return false;
+        }
+        queue.push_back(value);
+        return true;
+    };
+    auto try_pop(T& value) -> bool
+    {
+        std::lock_guard lock{ mutex };
+        if (queue.empty())
+        {
+            return false;
+        }
+        value = queue.front();
+        queue.pop_front();
+        return true;
+    };
+};
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <memory>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/pool_allocator.hpp"
+
+/*
+    Message sized buffers built and dropped over and over, from several threads at once.
+*/
+
+template <typename A>
+static void churn(benchmark::State& state)
+{
+    constexpr std::size_t sizes[] = { 64, 256, 1500, 4096, 64, 512, 9000, 256 };
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        dynamic_buffer<std::byte, A> buffer(uninitialized, sizes[i++ % std::size(sizes)]);
+        benchmark::DoNotOptimize(buffer.data);
+    }
+};
+
+template <typename A>
+static void churn_held(benchmark::State& state)
+{
+    constexpr std::size_t sizes[] = { 64, 256, 1500, 4096, 64, 512, 9000, 256 };
+    constexpr std::size_t held = 64;
+    dynamic_buffer<std::byte, A> window[held];
+    std::size_t i = 0;
+    for (auto _ : state)
+    {
+        window[i % held] = dynamic_buffer<std::byte, A>(uninitialized, sizes[i % std::size(sizes)]);
+        benchmark::DoNotOptimize(window[i % held].data);
+        ++i;
+    }
+};
+
+BENCHMARK_TEMPLATE(churn, std::allocator<std::byte>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(churn, pool_allocator<std::byte>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(churn_held, std::allocator<std::byte>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK_TEMPLATE(churn_held, pool_allocator<std::byte>)->ThreadRange(1, 8)->UseRealTime();
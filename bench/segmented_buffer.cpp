@@ -0,0 +1,58 @@
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/segmented_buffer.hpp"
+
+/*
+    Growing in steps, where dynamic_buffer copies everything it holds each time it outgrows its block
+    and segmented_buffer only adds chunks. Then summing, element by element through the directory
+    against chunk by chunk through segments().
+*/
+
+template <typename Buffer>
+static void grow_in_steps(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    const std::size_t step = count / 16;
+    for (auto _ : state)
+    {
+        Buffer buffer{};
+        for (std::size_t size = step; size <= count; size += step)
+        {
+            buffer.resize(size, 1.0f);
+        }
+        benchmark::DoNotOptimize(buffer[0]);
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+};
+
+static void sum_elements(benchmark::State& state)
+{
+    const segmented_buffer<float> buffer(state.range(0), 1.0f);
+    for (auto _ : state)
+    {
+        float total = std::reduce(buffer.begin(), buffer.end(), 0.0f);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size * sizeof(float));
+};
+
+static void sum_segments(benchmark::State& state)
+{
+    const segmented_buffer<float> buffer(state.range(0), 1.0f);
+    for (auto _ : state)
+    {
+        float total = 0.0f;
+        for (std::span<const float> segment : buffer.segments())
+        {
+            total = std::reduce(segment.begin(), segment.end(), total);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * buffer.size * sizeof(float));
+};
+
+BENCHMARK(grow_in_steps<dynamic_buffer<float>>)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+BENCHMARK(grow_in_steps<segmented_buffer<float>>)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+BENCHMARK(sum_elements)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
+BENCHMARK(sum_segments)->RangeMultiplier(16)->Range(1 << 16, 1 << 24);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include "containers/shared_buffer.hpp"
+
+/*
+    Handing one decoded payload to four consumers, by copying the dynamic_buffer for each
+    as before, by freezing it and giving each a shared_buffer before thawing it again,
+    and by giving each a quarter of it as a slice.
+*/
+
+static constexpr std::size_t consumers = 4;
+
+static void handoff_copy(benchmark::State& state)
+{
+    const dynamic_buffer<std::uint8_t> payload(state.range(0), std::uint8_t{ 1 });
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < consumers; ++i)
+        {
+            dynamic_buffer<std::uint8_t> copy{ payload };
+            benchmark::DoNotOptimize(copy.data);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+};
+
+static void handoff_shared(benchmark::State& state)
+{
+    dynamic_buffer<std::uint8_t> payload(state.range(0), std::uint8_t{ 1 });
+    for (auto _ : state)
+    {
+        // freezing and thawing the sole owner hands the same storage back and forth.
+        shared_buffer<std::uint8_t> frozen{ std::move(payload) };
+        for (std::size_t i = 0; i < consumers; ++i)
+        {
+            shared_buffer<std::uint8_t> copy{ frozen };
+            benchmark::DoNotOptimize(copy.data);
+        }
+        payload = std::move(frozen).thaw();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+};
+
+static void handoff_slices(benchmark::State& state)
+{
+    const shared_buffer<std::uint8_t> frozen{ dynamic_buffer<std::uint8_t>(state.range(0), std::uint8_t{ 1 }) };
+    const std::size_t quarter = frozen.size / consumers;
+    for (auto _ : state)
+    {
+        for (std::size_t i = 0; i < consumers; ++i)
+        {
+            shared_buffer<std::uint8_t> slice = frozen.slice(i * quarter, quarter);
+            benchmark::DoNotOptimize(slice.data);
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+};
+
+BENCHMARK(handoff_copy)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+BENCHMARK(handoff_shared)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
+BENCHMARK(handoff_slices)->RangeMultiplier(16)->Range(1 << 10, 1 << 26);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/small_buffer.hpp"
+
+/*
+    Counts the allocations each container makes, reported per iteration next to the latency.
+*/
+
+inline std::size_t allocation_count = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T>
+{
+    using value_type = T;
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) {};
+
+    auto allocate(std::size_t count) -> T*
+    {
+        ++allocation_count;
+        return std::allocator<T>::allocate(count);
+    };
+};
+
+template <typename Buffer>
+static void construct_and_destroy(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    allocation_count = 0;
+    for (auto _ : state)
+    {
+        Buffer buffer(size, std::uint32_t{ 1 });
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocation_count), benchmark::Counter::kAvgIterations);
+};
+
+template <typename Buffer>
+static void copy(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    const Buffer source(size, std::uint32_t{ 1 });
+    allocation_count = 0;
+    for (auto _ : state)
+    {
+        Buffer buffer{ source };
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocation_count), benchmark::Counter::kAvgIterations);
+};
+
+template <typename Buffer>
+static void grow(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    allocation_count = 0;
+    for (auto _ : state)
+    {
+        Buffer buffer{};
+        for (std::size_t i = 1; i <= size; ++i)
+        {
+            buffer.resize(i, std::uint32_t{ 1 });
+        }
+        benchmark::DoNotOptimize(buffer.data);
+    }
+    state.counters["allocations"] = benchmark::Counter(static_cast<double>(allocation_count), benchmark::Counter::kAvgIterations);
+};
+
+template <typename Buffer>
+static void move(benchmark::State& state)
+{
+    const auto size = static_cast<std::size_t>(state.range(0));
+    Buffer buffer(size, std::uint32_t{ 1 });
+    for (auto _ : state)
+    {
+        Buffer other{ std::move(buffer) };
+        benchmark::DoNotOptimize(other.data);
+        buffer = std::move(other);
+    }
+};
+
+using dynamic = dynamic_buffer<std::uint32_t, counting_allocator<std::uint32_t>>;
+using small = small_buffer<std::uint32_t, 32, counting_allocator<std::uint32_t>>;
+
+BENCHMARK_TEMPLATE(construct_and_destroy, dynamic)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(construct_and_destroy, small)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(copy, dynamic)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(copy, small)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(grow, dynamic)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(grow, small)->Arg(4)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(move, dynamic)->Arg(4)->Arg(32)->Arg(64);
+BENCHMARK_TEMPLATE(move, small)->Arg(4)->Arg(32)->Arg(64);
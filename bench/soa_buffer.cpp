@@ -0,0 +1,49 @@
+#include <benchmark/benchmark.h>
+#include <numeric>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/soa_buffer.hpp"
+
+/*
+    Summing one field of a particle, stored as an array of structures in a dynamic_buffer against a
+    column of an soa_buffer. The structure layout drags every other field through the cache with it.
+*/
+
+struct particle
+{
+    float x, y, z;
+    float vx, vy, vz;
+    float mass;
+    int id;
+};
+
+static void array_of_structures(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    dynamic_buffer<particle> particles(count, particle{ 0, 0, 0, 0, 0, 0, 1.0f, 0 });
+    for (auto _ : state)
+    {
+        float total = 0.0f;
+        for (const particle& p : particles)
+        {
+            total += p.mass;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+};
+
+static void structure_of_arrays(benchmark::State& state)
+{
+    const std::size_t count = state.range(0);
+    soa_buffer<float, float, float, float, float, float, float, int> particles{ count, 0, 0, 0, 0, 0, 0, 1.0f, 0 };
+    for (auto _ : state)
+    {
+        const auto mass = particles.column<6>();
+        float total = std::reduce(mass.begin(), mass.end(), 0.0f);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetBytesProcessed(state.iterations() * count * sizeof(float));
+};
+
+BENCHMARK(array_of_structures)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(structure_of_arrays)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,114 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <thread>
+#include "containers/spsc_ring.hpp"
+#include "mutex_queue.hpp"
+
+/*
+    spsc_ring against a std::deque behind a mutex, one producer thread and one consumer thread.
+    Throughput moves a fixed number of records per iteration, latency bounces one record back and forth.
+*/
+
+struct record
+{
+    std::uint64_t sequence;
+    std::uint64_t payload[7];
+};
+
+constexpr std::size_t transfer_count = 1 << 16;
+
+template <typename Queue>
+static void throughput(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        Queue queue(1024);
+        std::thread producer{ [&]
+        {
+            for (std::uint64_t i = 0; i < transfer_count;)
+            {
+                i += queue.try_push(record{ i, {} });
+            }
+        } };
+
+        record value{};
+        for (std::uint64_t i = 0; i < transfer_count;)
+        {
+            i += queue.try_pop(value);
+        }
+        benchmark::DoNotOptimize(value);
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * transfer_count);
+};
+
+static void throughput_batched(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        spsc_ring<record> queue(1024);
+        std::thread producer{ [&]
+        {
+            for (std::uint64_t i = 0; i < transfer_count;)
+            {
+                auto slots = queue.writable();
+                std::size_t written = 0;
+                for (; written < slots.size() and i < transfer_count; ++written, ++i)
+                {
+                    slots[written].sequence = i;
+                }
+                queue.commit_write(written);
+            }
+        } };
+
+        std::uint64_t sum = 0;
+        for (std::uint64_t i = 0; i < transfer_count;)
+        {
+            auto slots = queue.readable();
+            for (const record& value : slots)
+            {
+                sum += value.sequence;
+            }
+            queue.commit_read(slots.size());
+            i += slots.size();
+        }
+        benchmark::DoNotOptimize(sum);
+        producer.join();
+    }
+    state.SetItemsProcessed(state.iterations() * transfer_count);
+};
+
+template <typename Queue>
+static void round_trip(benchmark::State& state)
+{
+    constexpr std::size_t trips = 1 << 12;
+    for (auto _ : state)
+    {
+        Queue ping(16);
+        Queue pong(16);
+        std::thread echo{ [&]
+        {
+            record value{};
+            for (std::size_t i = 0; i < trips; ++i)
+            {
+                while (not ping.try_pop(value)) {}
+                while (not pong.try_push(value)) {}
+            }
+        } };
+
+        record value{};
+        for (std::uint64_t i = 0; i < trips; ++i)
+        {
+            while (not ping.try_push(record{ i, {} })) {}
+            while (not pong.try_pop(value)) {}
+        }
+        echo.join();
+    }
+    state.SetItemsProcessed(state.iterations() * trips);
+};
+
+BENCHMARK_TEMPLATE(throughput, spsc_ring<record>)->UseRealTime();
+BENCHMARK_TEMPLATE(throughput, mutex_queue<record>)->UseRealTime();
+BENCHMARK(throughput_batched)->UseRealTime();
+BENCHMARK_TEMPLATE(round_trip, spsc_ring<record>)->UseRealTime();
+BENCHMARK_TEMPLATE(round_trip, mutex_queue<record>)->UseRealTime();
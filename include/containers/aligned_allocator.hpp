@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+#include "dynamic_buffer.hpp"
+
+/*
+    An allocator whose blocks start on an Alignment byte boundary, 64 by default to match a cache line
+    and an AVX-512 register.
+*/
+
+template <typename T, std::size_t Alignment = 64>
+struct aligned_allocator
+{
+    static_assert((Alignment & (Alignment - 1)) == 0, "alignment must be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment must not be weaker than the element's");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    static constexpr std::size_t alignment = Alignment;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    constexpr aligned_allocator() noexcept = default;
+    template <typename U>
+    constexpr aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {};
+
+    auto allocate(size_type count) -> T*;
+    auto deallocate(T* data, size_type count) noexcept -> void;
+
+    template <typename U>
+    constexpr auto operator ==(const aligned_allocator<U, Alignment>&) const noexcept -> bool
+    {
+        return true;
+    };
+};
+
+template <typename T, std::size_t Alignment = 64>
+using aligned_buffer = dynamic_buffer<T, aligned_allocator<T, Alignment>>;
+
+template <typename T, std::size_t Alignment>
+auto aligned_allocator<T, Alignment>::allocate(size_type count) -> T*
+{
+    if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{ Alignment }));
+};
+
+template <typename T, std::size_t Alignment>
+auto aligned_allocator<T, Alignment>::deallocate(T* data, size_type count) noexcept -> void
+{
+    ::operator delete(data, count * sizeof(T), std::align_val_t{ Alignment });
+};
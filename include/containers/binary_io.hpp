@@ -0,0 +1,374 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <system_error>
+#include <type_traits>
+
+#include "contract.hpp"
+#include "dynamic_buffer.hpp"
+
+#ifndef CONTAINERS_HAS_UIO
+#if __has_include(<sys/uio.h>)
+#define CONTAINERS_HAS_UIO 1
+#else
+#define CONTAINERS_HAS_UIO 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_UIO
+#include <climits>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/*
+    Writes and reads dynamic_buffers of trivially copyable elements straight to and from file descriptors
+    and std::FILE streams, without staging the bytes anywhere.
+
+    write_buffer puts a buffer_header before the elements, read_buffer checks it and sizes the buffer
+    from it in one allocation, reading into uninitialized storage. When the source can tell how much is
+    left, a header counting more elements than that is rejected before anything is allocated. write_elements and read_elements move
+    bare elements with no header. Descriptors are driven with writev and readv, header and elements in
+    one call, retried after short transfers and EINTR.
+
+    System failures are reported as std::system_error carrying errno. A header that does not match,
+    a bad checksum or a stream that ends early are reported with std::errc::illegal_byte_sequence.
+*/
+
+struct buffer_header
+{
+    static constexpr std::uint32_t expected_magic = 0x4655'4244; // "DBUF" read as little endian.
+    static constexpr std::uint16_t current_version = 1;
+
+    std::uint32_t magic = expected_magic;
+    std::uint16_t version = current_version;
+    // 1 when written on a little endian machine, 0 for big endian.
+    std::uint8_t little_endian = std::endian::native == std::endian::little;
+    std::uint8_t reserved = 0;
+    std::uint32_t element_size = 0;
+    std::uint32_t element_alignment = 0;
+    std::uint64_t count = 0;
+    std::uint64_t checksum = 0;
+};
+static_assert(sizeof(buffer_header) == 32 and std::is_trivially_copyable_v<buffer_header>);
+
+/*
+    Fletcher style checksum over 64 bit words, with the trailing bytes zero padded into one last word.
+    Runs at memory speed, but only catches accidental damage.
+*/
+inline auto buffer_checksum(const void* data, std::size_t bytes) noexcept -> std::uint64_t
+{
+    const auto* source = static_cast<const std::byte*>(data);
+    std::uint64_t sum = 0;
+    std::uint64_t weighted = bytes;
+    std::size_t offset = 0;
+    for (; offset + sizeof(std::uint64_t) <= bytes; offset += sizeof(std::uint64_t))
+    {
+        std::uint64_t word;
+        std::memcpy(&word, source + offset, sizeof(word));
+        sum += word;
+        weighted += sum;
+    }
+    if (offset < bytes)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, source + offset, bytes - offset);
+        sum += word;
+        weighted += sum;
+    }
+    return sum ^ (weighted << 1 | weighted >> 63);
+};
+
+[[noreturn]] inline auto throw_format_error(const char* what) -> void
+{
+    throw std::system_error{ std::make_error_code(std::errc::illegal_byte_sequence), what };
+};
+
+// the largest transfer handed to one iovec, below the 2 GiB some kernels stop at.
+inline constexpr std::size_t io_slice = std::size_t{ 1 } << 30;
+
+/*
+    Moves every byte described by vectors, a slice at a time, resuming after short transfers.
+    Returns the bytes moved, which is less than requested only when a read reaches the end of the file.
+*/
+template <bool Writing>
+auto transfer_vectors(int descriptor, std::span<::iovec> vectors) -> std::size_t
+{
+    std::size_t moved = 0;
+    std::size_t first = 0;
+    while (first < vectors.size())
+    {
+        if (vectors[first].iov_len == 0)
+        {
+            ++first;
+            continue;
+        }
+
+        const int count = static_cast<int>(std::min<std::size_t>(vectors.size() - first, IOV_MAX));
+        ::ssize_t result = 0;
+        if constexpr (Writing)
+        {
+            result = ::writev(descriptor, vectors.data() + first, count);
+        }
+        else
+        {
+            result = ::readv(descriptor, vectors.data() + first, count);
+        }
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error{ errno, std::generic_category(), Writing ? "writev" : "readv" };
+        }
+        if (result == 0)
+        {
+            return moved;
+        }
+
+        auto left = static_cast<std::size_t>(result);
+        moved += left;
+        while (left > 0)
+        {
+            const std::size_t step = std::min(left, vectors[first].iov_len);
+            vectors[first].iov_base = static_cast<std::byte*>(vectors[first].iov_base) + step;
+            vectors[first].iov_len -= step;
+            left -= step;
+            if (vectors[first].iov_len == 0)
+            {
+                ++first;
+            }
+        }
+    }
+    return moved;
+};
+
+template <bool Writing>
+auto transfer_vectors(std::FILE* stream, std::span<::iovec> vectors) -> std::size_t
+{
+    std::size_t moved = 0;
+    for (const ::iovec& vector : vectors)
+    {
+        std::size_t done = 0;
+        if constexpr (Writing)
+        {
+            done = std::fwrite(vector.iov_base, 1, vector.iov_len, stream);
+        }
+        else
+        {
+            done = std::fread(vector.iov_base, 1, vector.iov_len, stream);
+        }
+        moved += done;
+        if (done < vector.iov_len)
+        {
+            if (std::ferror(stream))
+            {
+                throw std::system_error{ errno, std::generic_category(), Writing ? "fwrite" : "fread" };
+            }
+            return moved;
+        }
+    }
+    return moved;
+};
+
+/*
+    Cuts [data, data + bytes) into io_slice sized vectors after the ones already in vectors.
+*/
+inline auto append_slices(dynamic_buffer<::iovec>& vectors, std::size_t used, void* data, std::size_t bytes) -> std::size_t
+{
+    const std::size_t slices = (bytes + io_slice - 1) / io_slice;
+    vectors.resize(used + slices);
+    for (std::size_t i = 0; i < slices; ++i)
+    {
+        const std::size_t offset = i * io_slice;
+        vectors[used + i] = ::iovec{ static_cast<std::byte*>(data) + offset, std::min(io_slice, bytes - offset) };
+    }
+    return used + slices;
+};
+
+template <typename Target, typename T, std::size_t N>
+auto write_elements(Target target, std::span<T, N> elements) -> void
+{
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be written as bytes");
+
+    dynamic_buffer<::iovec> vectors{};
+    const std::size_t used = append_slices(vectors, 0, const_cast<std::remove_const_t<T>*>(elements.data()), elements.size_bytes());
+    transfer_vectors<true>(target, std::span{ std::to_address(vectors.data), used });
+};
+
+/*
+    Fills elements completely, throwing if the stream ends first.
+*/
+template <typename Target, typename T, std::size_t N>
+auto read_elements(Target target, std::span<T, N> elements) -> void
+{
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be read as bytes");
+
+    dynamic_buffer<::iovec> vectors{};
+    const std::size_t used = append_slices(vectors, 0, elements.data(), elements.size_bytes());
+    if (transfer_vectors<false>(target, std::span{ std::to_address(vectors.data), used }) != elements.size_bytes())
+    {
+        throw_format_error("stream ended before every element was read");
+    }
+};
+
+template <typename T>
+auto make_header(std::span<const T> elements) noexcept -> buffer_header
+{
+    buffer_header header{};
+    header.element_size = sizeof(T);
+    header.element_alignment = alignof(T);
+    header.count = elements.size();
+    header.checksum = buffer_checksum(elements.data(), elements.size_bytes());
+    return header;
+};
+
+/*
+    Writes the header and the elements with a single writev where the size allows.
+*/
+template <typename Target, typename T, typename A>
+auto write_buffer(Target target, const dynamic_buffer<T, A>& buffer) -> void
+{
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be written as bytes");
+
+    const std::span<const T> elements{ std::to_address(buffer.data), buffer.size };
+    buffer_header header = make_header(elements);
+
+    dynamic_buffer<::iovec> vectors{};
+    std::size_t used = append_slices(vectors, 0, &header, sizeof(header));
+    used = append_slices(vectors, used, const_cast<T*>(elements.data()), elements.size_bytes());
+    transfer_vectors<true>(target, std::span{ std::to_address(vectors.data), used });
+};
+
+/*
+    Reads a header and checks that it describes elements of type T written on a machine of the same endianness.
+*/
+template <typename T, typename Target>
+auto read_header(Target target) -> buffer_header
+{
+    buffer_header header{};
+    ::iovec vector{ &header, sizeof(header) };
+    if (transfer_vectors<false>(target, std::span{ &vector, 1 }) != sizeof(header))
+    {
+        throw_format_error("stream ended inside the buffer header");
+    }
+
+    if (header.magic != buffer_header::expected_magic)
+    {
+        throw_format_error(header.magic == std::byteswap(buffer_header::expected_magic) ?
+            "buffer was written with the other endianness" : "not a buffer header");
+    }
+    if (header.version != buffer_header::current_version)
+    {
+        throw_format_error("unknown buffer header version");
+    }
+    if (header.element_size != sizeof(T) or header.element_alignment != alignof(T))
+    {
+        throw_format_error("buffer holds elements of another type");
+    }
+    if (header.count > std::numeric_limits<std::size_t>::max() / sizeof(T))
+    {
+        throw_format_error("buffer is too large to read");
+    }
+    return header;
+};
+
+/*
+    How many bytes are left to read from a regular file, or nothing when the source cannot tell,
+    such as a pipe or a socket.
+*/
+inline auto remaining_bytes(int descriptor) -> std::optional<std::uint64_t>
+{
+    struct ::stat status{};
+    if (::fstat(descriptor, &status) != 0 or not S_ISREG(status.st_mode))
+    {
+        return std::nullopt;
+    }
+
+    const ::off_t position = ::lseek(descriptor, 0, SEEK_CUR);
+    if (position < 0)
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::uint64_t>(std::max<::off_t>(status.st_size - position, 0));
+};
+
+inline auto remaining_bytes(std::FILE* stream) -> std::optional<std::uint64_t>
+{
+    const ::off_t position = ::ftello(stream);
+    if (position < 0 or ::fseeko(stream, 0, SEEK_END) != 0)
+    {
+        return std::nullopt;
+    }
+
+    const ::off_t end = ::ftello(stream);
+    if (::fseeko(stream, position, SEEK_SET) != 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), "fseeko" };
+    }
+    if (end < 0)
+    {
+        return std::nullopt;
+    }
+    return static_cast<std::uint64_t>(std::max<::off_t>(end - position, 0));
+};
+
+/*
+    Reads a buffer written by write_buffer into buffer, reusing its storage when it is large enough
+    and otherwise dropping the old elements before allocating, so they are never copied.
+    On failure buffer is left empty.
+*/
+template <typename Target, typename T, typename A>
+auto read_buffer(Target target, dynamic_buffer<T, A>& buffer) -> void
+{
+    static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable elements can be read as bytes");
+
+    try
+    {
+        const buffer_header header = read_header<T>(target);
+        // a damaged or truncated header must not size the buffer past what the source still holds.
+        if (const auto remaining = remaining_bytes(target); remaining and header.count > *remaining / sizeof(T))
+        {
+            throw_format_error("buffer header counts more elements than the stream holds");
+        }
+
+        // the old elements are about to be overwritten, so growing should not copy them first.
+        const auto count = static_cast<std::size_t>(header.count);
+        if (count > buffer.capacity)
+        {
+            buffer.release_storage();
+        }
+        buffer.resize(uninitialized, count);
+        const std::span<T> elements{ std::to_address(buffer.data), buffer.size };
+        read_elements(target, elements);
+        if (buffer_checksum(elements.data(), elements.size_bytes()) != header.checksum)
+        {
+            throw_format_error("buffer checksum does not match");
+        }
+    }
+    catch (...)
+    {
+        buffer.release_storage();
+        throw;
+    }
+};
+
+template <typename T, typename A = std::allocator<T>, typename Target>
+auto read_buffer(Target target, const A& allocator = A{}) -> dynamic_buffer<T, A>
+{
+    dynamic_buffer<T, A> buffer{ std::allocator_arg, allocator };
+    read_buffer(target, buffer);
+    return buffer;
+};
+#endif
@@ -0,0 +1,671 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A buffer of unsigned integers that each take only Width bits, for columns whose values sit far below
+    the range of their type. Can only change size when explicitly resized, like dynamic_buffer.
+
+    Values are packed into 32 bit words, in blocks of 256 values spread over 8 lanes: value r of a block
+    goes to lane r % 8, and each lane packs its 32 values into Width words of its own, interleaved with
+    the other lanes so that word j of every lane sits together. A block takes exactly Width * 8 words.
+    Finding any one value is a little arithmetic on its index, so reads and writes stay O(1), and packing
+    or unpacking a whole block applies the same constant shifts to 8 neighbouring words at once, which
+    compilers turn into vector instructions without any intrinsics.
+
+    Width is fixed at compile time, or given at runtime with bitpacked_buffer<dynamic_width>, whose bulk
+    operations dispatch to the same kernels through a table. Widths run from 1 to 32 bits.
+    Elements are read and written through proxy references, the iterators are random access.
+    Storage is kept in whole blocks followed by one row of padding, so any value can be read from a pair
+    of words without checking whether it crosses into the next. Every bit past the last value is zero.
+    A moved from bitpacked_buffer holds no values and may only be assigned to or destroyed.
+*/
+
+constexpr std::size_t dynamic_width = 0;
+
+constexpr std::size_t bitpacked_lanes = 8;
+constexpr std::size_t bitpacked_block_size = 32 * bitpacked_lanes;
+
+/*
+    Packs row Row of a block, the Row-th value of every lane, into words at the offset it has in its lane.
+*/
+template <std::size_t Width, std::size_t Row, typename U>
+auto pack_bit_row(const U* __restrict values, std::uint32_t* __restrict words) noexcept -> void
+{
+    constexpr std::uint32_t mask = ~std::uint32_t{ 0 } >> (32 - Width);
+    constexpr std::size_t word = Row * Width / 32 * bitpacked_lanes;
+    constexpr std::size_t offset = Row * Width % 32;
+
+    for (std::size_t lane = 0; lane < bitpacked_lanes; ++lane)
+    {
+        const std::uint32_t value = static_cast<std::uint32_t>(values[lane]) & mask;
+        words[word + lane] |= value << offset;
+        if constexpr (offset + Width > 32)
+        {
+            words[word + bitpacked_lanes + lane] |= value >> (32 - offset);
+        }
+    }
+};
+
+template <std::size_t Width, std::size_t Row, typename U>
+auto unpack_bit_row(const std::uint32_t* __restrict words, U* __restrict values) noexcept -> void
+{
+    constexpr std::uint32_t mask = ~std::uint32_t{ 0 } >> (32 - Width);
+    constexpr std::size_t word = Row * Width / 32 * bitpacked_lanes;
+    constexpr std::size_t offset = Row * Width % 32;
+
+    for (std::size_t lane = 0; lane < bitpacked_lanes; ++lane)
+    {
+        std::uint32_t value = words[word + lane] >> offset;
+        if constexpr (offset + Width > 32)
+        {
+            value |= words[word + bitpacked_lanes + lane] << (32 - offset);
+        }
+        values[lane] = static_cast<U>(value & mask);
+    }
+};
+
+/*
+    Packs count whole blocks of values into words, truncating every value to its low Width bits.
+    The row kernels take restrict pointers, otherwise the lane loops only vectorize behind runtime overlap checks.
+*/
+template <std::size_t Width, typename U>
+auto pack_bit_blocks(const U* values, std::uint32_t* words, std::size_t count) noexcept -> void
+{
+    for (std::size_t block = 0; block < count; ++block)
+    {
+        std::fill_n(words, Width * bitpacked_lanes, std::uint32_t{ 0 });
+        [&]<std::size_t... Rows>(std::index_sequence<Rows...>)
+        {
+            (pack_bit_row<Width, Rows>(values + Rows * bitpacked_lanes, words), ...);
+        }(std::make_index_sequence<32>{});
+        values += bitpacked_block_size;
+        words += Width * bitpacked_lanes;
+    }
+};
+
+template <std::size_t Width, typename U>
+auto unpack_bit_blocks(const std::uint32_t* words, U* values, std::size_t count) noexcept -> void
+{
+    for (std::size_t block = 0; block < count; ++block)
+    {
+        [&]<std::size_t... Rows>(std::index_sequence<Rows...>)
+        {
+            (unpack_bit_row<Width, Rows>(words, values + Rows * bitpacked_lanes), ...);
+        }(std::make_index_sequence<32>{});
+        values += bitpacked_block_size;
+        words += Width * bitpacked_lanes;
+    }
+};
+
+// the block kernels for every width, indexed by the width, for buffers whose width is only known at runtime.
+template <typename U>
+constexpr auto pack_bit_kernels = []<std::size_t... Widths>(std::index_sequence<Widths...>)
+{
+    using kernel = auto (*)(const U*, std::uint32_t*, std::size_t) noexcept -> void;
+    return std::array<kernel, 33>{ nullptr, &pack_bit_blocks<Widths + 1, U>... };
+}(std::make_index_sequence<32>{});
+
+template <typename U>
+constexpr auto unpack_bit_kernels = []<std::size_t... Widths>(std::index_sequence<Widths...>)
+{
+    using kernel = auto (*)(const std::uint32_t*, U*, std::size_t) noexcept -> void;
+    return std::array<kernel, 33>{ nullptr, &unpack_bit_blocks<Widths + 1, U>... };
+}(std::make_index_sequence<32>{});
+
+template <std::size_t Width = dynamic_width, typename A = std::allocator<std::uint32_t>>
+struct bitpacked_buffer
+{
+    static_assert(Width <= 32, "values are packed into 32 bit words");
+
+    using word_type = std::uint32_t;
+    using traits = typename std::allocator_traits<A>::template rebind_traits<word_type>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = std::uint32_t;
+    using size_type = std::size_t;
+    using words_type = dynamic_buffer<word_type, allocator_type>;
+
+    static constexpr bool is_dynamic = Width == dynamic_width;
+    static constexpr size_type block_size = bitpacked_block_size;
+    static constexpr size_type lanes = bitpacked_lanes;
+
+    size_type size = 0;
+    // the number of bits in every value, only stored when it is not part of the type.
+    [[no_unique_address]] std::conditional_t<is_dynamic, size_type, std::integral_constant<size_type, Width>> width = {};
+    words_type words = {};
+
+    bitpacked_buffer() = default;
+    bitpacked_buffer(const bitpacked_buffer& other) = default;
+    bitpacked_buffer(bitpacked_buffer&& other) noexcept;
+    auto operator =(bitpacked_buffer other) noexcept -> bitpacked_buffer&;
+
+    explicit bitpacked_buffer(const allocator_type& allocator) noexcept requires (not is_dynamic);
+    explicit bitpacked_buffer(size_type size) requires (not is_dynamic);
+    bitpacked_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size) requires (not is_dynamic);
+    template <std::unsigned_integral U>
+    explicit bitpacked_buffer(std::span<const U> values) requires (not is_dynamic);
+
+    bitpacked_buffer(size_type width, const allocator_type& allocator) noexcept requires (is_dynamic);
+    bitpacked_buffer(size_type width, size_type size) requires (is_dynamic);
+    bitpacked_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type width, size_type size) requires (is_dynamic);
+    template <std::unsigned_integral U>
+    bitpacked_buffer(size_type width, std::span<const U> values) requires (is_dynamic);
+
+    struct packed_reference
+    {
+        bitpacked_buffer* buffer = nullptr;
+        size_type index = 0;
+
+        operator value_type() const noexcept
+        {
+            return buffer->get(index);
+        };
+        // assigning through a const proxy still writes the value, as proxies used by the ranges algorithms must.
+        auto operator =(value_type value) const noexcept -> const packed_reference&
+        {
+            buffer->set(index, value);
+            return *this;
+        };
+        auto operator =(const packed_reference& other) const noexcept -> const packed_reference&
+        {
+            return *this = static_cast<value_type>(other);
+        };
+        friend auto swap(const packed_reference& left, const packed_reference& right) noexcept -> void
+        {
+            const value_type value = left;
+            left = right;
+            right = value;
+        };
+    };
+
+    auto operator [](size_type index) noexcept -> packed_reference
+    {
+        return { this, index };
+    };
+    auto operator [](size_type index) const noexcept -> value_type
+    {
+        return get(index);
+    };
+
+    auto max_value() const noexcept -> value_type
+    {
+        return ~word_type{ 0 } >> (32 - width);
+    };
+    static constexpr auto words_for(size_type count, size_type width) noexcept -> size_type
+    {
+        return count == 0 ? 0 : (count + block_size - 1) / block_size * width * lanes + lanes;
+    };
+
+    auto get(size_type index) const noexcept -> value_type;
+    auto set(size_type index, value_type value) noexcept -> void;
+
+    auto resize(size_type size, value_type value = 0) -> void;
+    auto release_storage() noexcept -> void;
+
+    template <std::unsigned_integral U>
+    auto pack(size_type first, std::span<const U> values) noexcept -> void;
+    template <std::unsigned_integral U>
+    auto unpack(size_type first, std::span<U> values) const noexcept -> void;
+    template <std::unsigned_integral U, typename B>
+    auto unpack(dynamic_buffer<U, B>& values) const -> void;
+
+    template <std::unsigned_integral U>
+    auto pack_blocks(const U* values, word_type* destination, size_type count) const noexcept -> void
+    {
+        if constexpr (is_dynamic)
+        {
+            pack_bit_kernels<U>[width](values, destination, count);
+        }
+        else
+        {
+            pack_bit_blocks<Width>(values, destination, count);
+        }
+    };
+    template <std::unsigned_integral U>
+    auto unpack_blocks(const word_type* source, U* values, size_type count) const noexcept -> void
+    {
+        if constexpr (is_dynamic)
+        {
+            unpack_bit_kernels<U>[width](source, values, count);
+        }
+        else
+        {
+            unpack_bit_blocks<Width>(source, values, count);
+        }
+    };
+
+    template <bool Const>
+    struct packed_iterator
+    {
+        using value_type = std::uint32_t;
+        using reference_type = std::conditional_t<Const, std::uint32_t, packed_reference>;
+        using buffer_type = std::conditional_t<Const, const bitpacked_buffer, bitpacked_buffer>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = reference_type;
+        using iterator_concept = std::random_access_iterator_tag;
+        // the elements are proxies, but the legacy algorithms still get random access, as with vector<bool>.
+        using iterator_category = std::random_access_iterator_tag;
+
+        buffer_type* buffer = nullptr;
+        difference_type index = 0;
+
+        constexpr auto operator ==(const packed_iterator& other) const noexcept -> bool
+        {
+            return index == other.index;
+        };
+        constexpr auto operator <=>(const packed_iterator& other) const noexcept -> std::strong_ordering
+        {
+            return index <=> other.index;
+        };
+
+        constexpr auto operator *() const -> reference_type
+        {
+            return (*buffer)[index];
+        };
+        constexpr auto operator [](difference_type offset) const -> reference_type
+        {
+            return *(*this + offset);
+        };
+
+        constexpr auto operator ++() -> packed_iterator&
+        {
+            ++index;
+            return *this;
+        };
+        constexpr auto operator ++(int) -> packed_iterator
+        {
+            packed_iterator old = *this;
+            ++index;
+            return old;
+        };
+        constexpr auto operator --() -> packed_iterator&
+        {
+            --index;
+            return *this;
+        };
+        constexpr auto operator --(int) -> packed_iterator
+        {
+            packed_iterator old = *this;
+            --index;
+            return old;
+        };
+        constexpr auto operator +=(difference_type offset) -> packed_iterator&
+        {
+            index += offset;
+            return *this;
+        };
+        constexpr auto operator -=(difference_type offset) -> packed_iterator&
+        {
+            index -= offset;
+            return *this;
+        };
+        constexpr auto operator +(difference_type offset) const -> packed_iterator
+        {
+            return { buffer, index + offset };
+        };
+        constexpr friend auto operator +(difference_type offset, const packed_iterator& iter) -> packed_iterator
+        {
+            return iter + offset;
+        };
+        constexpr auto operator -(difference_type offset) const -> packed_iterator
+        {
+            return { buffer, index - offset };
+        };
+        constexpr auto operator -(const packed_iterator& other) const -> difference_type
+        {
+            return index - other.index;
+        };
+    };
+
+    using iterator = packed_iterator<false>;
+    using const_iterator = packed_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    auto begin() noexcept -> iterator
+    {
+        return iterator{ this, 0 };
+    };
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ this, 0 };
+    };
+    auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ this, 0 };
+    };
+    auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    auto end() noexcept -> iterator
+    {
+        return iterator{ this, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ this, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ this, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+    auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <std::size_t W, typename A>
+auto swap(bitpacked_buffer<W, A>& left, bitpacked_buffer<W, A>& right) noexcept -> void
+{
+    using std::swap;
+
+    swap(left.size, right.size);
+    swap(left.width, right.width);
+    swap(left.words, right.words);
+};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(bitpacked_buffer&& other) noexcept :
+    size{ std::exchange(other.size, 0) },
+    width{ other.width },
+    words{ std::move(other.words) }
+{};
+
+template <std::size_t W, typename A>
+auto bitpacked_buffer<W, A>::operator =(bitpacked_buffer other) noexcept -> bitpacked_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(const allocator_type& allocator) noexcept requires (not is_dynamic) :
+    words{ allocator }
+{};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(size_type size) requires (not is_dynamic) :
+    bitpacked_buffer{ std::allocator_arg, allocator_type{}, size }
+{};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size) requires (not is_dynamic) :
+    bitpacked_buffer{ allocator }
+{
+    resize(size);
+};
+
+template <std::size_t W, typename A>
+template <std::unsigned_integral U>
+bitpacked_buffer<W, A>::bitpacked_buffer(std::span<const U> values) requires (not is_dynamic) :
+    size{ values.size() },
+    words{ uninitialized, words_for(values.size(), W) }
+{
+    // only the last block may be partly filled, the others are overwritten whole.
+    if (size > 0)
+    {
+        std::fill_n(std::to_address(words.data) + words.size - (W + 1) * lanes, (W + 1) * lanes, word_type{ 0 });
+    }
+    pack(0, values);
+};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(size_type width, const allocator_type& allocator) noexcept requires (is_dynamic) :
+    width{ width },
+    words{ allocator }
+{
+    contract;
+        pre(width >= 1 and width <= 32);
+};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(size_type width, size_type size) requires (is_dynamic) :
+    bitpacked_buffer{ std::allocator_arg, allocator_type{}, width, size }
+{};
+
+template <std::size_t W, typename A>
+bitpacked_buffer<W, A>::bitpacked_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type width, size_type size) requires (is_dynamic) :
+    bitpacked_buffer{ width, allocator }
+{
+    resize(size);
+};
+
+template <std::size_t W, typename A>
+template <std::unsigned_integral U>
+bitpacked_buffer<W, A>::bitpacked_buffer(size_type width, std::span<const U> values) requires (is_dynamic) :
+    size{ values.size() },
+    width{ width },
+    words{ uninitialized, words_for(values.size(), width) }
+{
+    contract;
+        pre(width >= 1 and width <= 32);
+
+    if (size > 0)
+    {
+        std::fill_n(std::to_address(words.data) + words.size - (width + 1) * lanes, (width + 1) * lanes, word_type{ 0 });
+    }
+    pack(0, values);
+};
+
+/*
+    The word holding the first bit of value index is at
+        block * width * lanes + row * width / 32 * lanes + lane
+    with the value starting offset bits into it, and continuing lanes words further on if it crosses into the next.
+    Both words are always read and written together, a branch on the crossing would be mispredicted
+    for several of the rows in every block.
+*/
+template <std::size_t W, typename A>
+auto bitpacked_buffer<W, A>::get(size_type index) const noexcept -> value_type
+{
+    check_index(index, size);
+
+    const size_type bit = (index % block_size / lanes) * width;
+    const size_type offset = bit % 32;
+    const word_type* word = std::to_address(words.data) + index / block_size * width * lanes + bit / 32 * lanes + index % lanes;
+
+    const std::uint64_t pair = word[0] | std::uint64_t{ word[lanes] } << 32;
+    return static_cast<value_type>(pair >> offset) & max_value();
+};
+
+template <std::size_t W, typename A>
+auto bitpacked_buffer<W, A>::set(size_type index, value_type value) noexcept -> void
+{
+    check_index(index, size);
+    default_checking::check(value <= max_value());
+
+    const size_type bit = (index % block_size / lanes) * width;
+    const size_type offset = bit % 32;
+    word_type* word = std::to_address(words.data) + index / block_size * width * lanes + bit / 32 * lanes + index % lanes;
+
+    const std::uint64_t mask = std::uint64_t{ max_value() } << offset;
+    const std::uint64_t pair = ((word[0] | std::uint64_t{ word[lanes] } << 32) & ~mask) | std::uint64_t{ value } << offset;
+    word[0] = static_cast<word_type>(pair);
+    word[lanes] = static_cast<word_type>(pair >> 32);
+};
+
+/*
+    New values are set to value. Growing fills whole blocks from one packed block of copies.
+    Shrinking clears the values past the new end in the last block and the padding after it,
+    so the bits past the last value stay zero.
+    Has the strong exception guarantee.
+*/
+template <std::size_t W, typename A>
+auto bitpacked_buffer<W, A>::resize(size_type new_size, value_type value) -> void
+{
+    contract;
+        pre(width >= 1);
+        pre(value <= max_value());
+
+    if (new_size <= size)
+    {
+        const size_type cleared = std::min(size, (new_size + block_size - 1) / block_size * block_size);
+        for (size_type index = new_size; index < cleared; ++index)
+        {
+            set(index, 0);
+        }
+        words.resize(words_for(new_size, width));
+        if (new_size > 0)
+        {
+            std::fill_n(std::to_address(words.data) + words.size - lanes, lanes, word_type{ 0 });
+        }
+        size = new_size;
+        return;
+    }
+
+    words.resize(words_for(new_size, width), word_type{ 0 });
+    const size_type old_size = std::exchange(size, new_size);
+    if (value == 0)
+    {
+        return;
+    }
+
+    size_type index = old_size;
+    for (; index < new_size and index % block_size != 0; ++index)
+    {
+        set(index, value);
+    }
+    if (new_size - index >= block_size)
+    {
+        std::array<value_type, block_size> copies;
+        copies.fill(value);
+        std::array<word_type, 32 * lanes> block;
+        pack_blocks(copies.data(), block.data(), 1);
+        for (; new_size - index >= block_size; index += block_size)
+        {
+            std::memcpy(std::to_address(words.data) + index / block_size * width * lanes, block.data(), width * lanes * sizeof(word_type));
+        }
+    }
+    for (; index < new_size; ++index)
+    {
+        set(index, value);
+    }
+};
+
+template <std::size_t W, typename A>
+auto bitpacked_buffer<W, A>::release_storage() noexcept -> void
+{
+    words.release_storage();
+    size = 0;
+};
+
+/*
+    Overwrites the values from first on with values, each truncated to its low width bits.
+    Whole blocks go through the vectorized kernels, only a partial block at either end is written one value at a time.
+*/
+template <std::size_t W, typename A>
+template <std::unsigned_integral U>
+auto bitpacked_buffer<W, A>::pack(size_type first, std::span<const U> values) noexcept -> void
+{
+    contract;
+        pre(first <= size and values.size() <= size - first);
+
+    const value_type mask = max_value();
+    size_type index = first;
+    const size_type last = first + values.size();
+    for (; index < last and index % block_size != 0; ++index)
+    {
+        set(index, static_cast<value_type>(values[index - first]) & mask);
+    }
+
+    const size_type blocks = (last - index) / block_size;
+    pack_blocks(values.data() + (index - first), std::to_address(words.data) + index / block_size * width * lanes, blocks);
+    index += blocks * block_size;
+
+    for (; index < last; ++index)
+    {
+        set(index, static_cast<value_type>(values[index - first]) & mask);
+    }
+};
+
+template <std::size_t W, typename A>
+template <std::unsigned_integral U>
+auto bitpacked_buffer<W, A>::unpack(size_type first, std::span<U> values) const noexcept -> void
+{
+    contract;
+        pre(first <= size and values.size() <= size - first);
+
+    size_type index = first;
+    const size_type last = first + values.size();
+    for (; index < last and index % block_size != 0; ++index)
+    {
+        values[index - first] = static_cast<U>(get(index));
+    }
+
+    const size_type blocks = (last - index) / block_size;
+    unpack_blocks(std::to_address(words.data) + index / block_size * width * lanes, values.data() + (index - first), blocks);
+    index += blocks * block_size;
+
+    for (; index < last; ++index)
+    {
+        values[index - first] = static_cast<U>(get(index));
+    }
+};
+
+/*
+    Resizes values to hold every value without initializing them first, then unpacks into it.
+*/
+template <std::size_t W, typename A>
+template <std::unsigned_integral U, typename B>
+auto bitpacked_buffer<W, A>::unpack(dynamic_buffer<U, B>& values) const -> void
+{
+    values.resize(uninitialized, size);
+    unpack(0, std::span<U>{ std::to_address(values.data), size });
+};
+
+/*
+    Buffers of the same width compare their words, since the bits past the last value are always zero.
+*/
+template <std::size_t W, typename A>
+auto operator ==(const bitpacked_buffer<W, A>& left, const bitpacked_buffer<W, A>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+    if (left.width == right.width)
+    {
+        return equal_elements(std::to_address(left.words.data), std::to_address(right.words.data), left.words.size);
+    }
+    return std::equal(left.begin(), left.end(), right.begin());
+};
+
+template <std::size_t W = dynamic_width, typename A = std::allocator<std::uint32_t>>
+using bitpacked_buffer_iterator = typename bitpacked_buffer<W, A>::iterator;
+
+template <std::size_t W = dynamic_width, typename A = std::allocator<std::uint32_t>>
+using bitpacked_buffer_const_iterator = typename bitpacked_buffer<W, A>::const_iterator;
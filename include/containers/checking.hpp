@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <source_location>
+
+/*
+    How the buffers check the indices given to their element accessors, and the few postconditions
+    of their constructors and destructors. Every policy has a
+        check(condition, where) -> void
+    that is constexpr and noexcept, and what happens when condition is false is up to the policy.
+        no_checking         never looks at condition, so an access compiles to a plain load.
+        assert_checking     asserts, so it is checked unless NDEBUG is defined, as in a release build.
+        always_checking     checks in every build, and aborts with the location of the failed check.
+        sampled_checking<N> checks every N-th access on each thread, and aborts the same way.
+
+    default_checking is the policy the buffers use, picked for the whole build by CONTAINERS_CHECKING,
+    0 through 3 in the order above, with CONTAINERS_CHECKING_SAMPLE for N. Both are set by the CMake options
+    of the same names. Every translation unit must see the same values.
+    The other preconditions, those outside the hot paths, are still checked by the contract library.
+*/
+
+#ifndef CONTAINERS_CHECKING
+#define CONTAINERS_CHECKING 1
+#endif
+
+#ifndef CONTAINERS_CHECKING_SAMPLE
+#define CONTAINERS_CHECKING_SAMPLE 64
+#endif
+
+[[noreturn]] inline auto check_failed(const std::source_location& where) noexcept -> void
+{
+    std::fprintf(stderr, "%s:%u: %s: check failed\n", where.file_name(), static_cast<unsigned>(where.line()), where.function_name());
+    std::abort();
+};
+
+struct no_checking
+{
+    static constexpr auto check(bool, const std::source_location& = std::source_location::current()) noexcept -> void
+    {};
+};
+
+struct assert_checking
+{
+    static constexpr auto check([[maybe_unused]] bool condition, const std::source_location& = std::source_location::current()) noexcept -> void
+    {
+        assert(condition);
+    };
+};
+
+struct always_checking
+{
+    static constexpr auto check(bool condition, const std::source_location& where = std::source_location::current()) noexcept -> void
+    {
+        if (not condition) [[unlikely]]
+        {
+            check_failed(where);
+        }
+    };
+};
+
+template <std::uint32_t N>
+struct sampled_checking
+{
+    static_assert(N > 0, "checking one access in zero");
+
+    // counts down to the next access that is checked, separately on every thread.
+    static auto sample() noexcept -> bool
+    {
+        static thread_local std::uint32_t countdown = N;
+        if (--countdown == 0)
+        {
+            countdown = N;
+            return true;
+        }
+        return false;
+    };
+
+    static constexpr auto check(bool condition, const std::source_location& where = std::source_location::current()) noexcept -> void
+    {
+        if consteval
+        {
+            if (not condition)
+            {
+                check_failed(where);
+            }
+        }
+        else
+        {
+            if (sample() and not condition) [[unlikely]]
+            {
+                check_failed(where);
+            }
+        }
+    };
+};
+
+#if CONTAINERS_CHECKING == 0
+using default_checking = no_checking;
+#elif CONTAINERS_CHECKING == 1
+using default_checking = assert_checking;
+#elif CONTAINERS_CHECKING == 2
+using default_checking = always_checking;
+#elif CONTAINERS_CHECKING == 3
+using default_checking = sampled_checking<CONTAINERS_CHECKING_SAMPLE>;
+#else
+#error "CONTAINERS_CHECKING is 0 for no checking, 1 for assert, 2 for always or 3 for sampled"
+#endif
+
+/*
+    Checks that index is below size with the default policy.
+*/
+constexpr auto check_index(std::size_t index, std::size_t size, const std::source_location& where = std::source_location::current()) noexcept -> void
+{
+    default_checking::check(index < size, where);
+};
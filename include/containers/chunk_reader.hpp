@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <span>
+#include <system_error>
+#include <thread>
+
+#include "contract.hpp"
+#include "aligned_allocator.hpp"
+#include "dynamic_buffer.hpp"
+
+#ifndef CONTAINERS_HAS_UNISTD
+#if __has_include(<unistd.h>)
+#define CONTAINERS_HAS_UNISTD 1
+#else
+#define CONTAINERS_HAS_UNISTD 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_UNISTD
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+    Reads a file descriptor a chunk at a time on a background thread, keeping up to depth chunks filled
+    ahead of the consumer, so reading the next chunk overlaps with processing the current one.
+    depth is at least two, one chunk being processed and one being filled.
+
+    Every chunk is a page aligned dynamic_buffer allocated once up front and recycled: the span returned by
+    next() stays valid until the following call to next(), after which its chunk is handed back to be
+    filled again. Slots are passed between the two threads with per-slot sequence numbers, as in mpmc_queue.
+    Only one thread may call next(). The descriptor is not closed, and must outlive the reader.
+    Pipes and sockets are polled together with a wake up pipe, so destroying the reader does not wait
+    on one that has nothing more to say. Regular files are read directly. A read error is rethrown from the next() that reaches it.
+*/
+
+struct chunk_reader
+{
+    using size_type = std::size_t;
+
+    static constexpr std::size_t cache_line = 64;
+    static constexpr std::size_t chunk_alignment = 4096;
+
+    using chunk_type = aligned_buffer<std::byte, chunk_alignment>;
+
+    struct alignas(cache_line) slot
+    {
+        // position p may fill the slot when this is p, and read it when this is p + 1.
+        std::atomic<size_type> sequence = 0;
+        chunk_type storage = {};
+        size_type filled = 0;
+        bool last = false;
+        std::exception_ptr failure = nullptr;
+    };
+
+    int descriptor = -1;
+    size_type chunk_size = 0;
+    dynamic_buffer<slot, aligned_allocator<slot, cache_line>> slots;
+    // the consumer's next position, and whether it still holds the slot before it.
+    size_type position = 0;
+    bool holding = false;
+    bool finished = false;
+    std::atomic<bool> stopping = false;
+    bool pollable = false;
+    int wake[2] = { -1, -1 };
+    std::thread filler;
+
+    chunk_reader(int descriptor, size_type chunk_size, size_type depth = 2);
+    chunk_reader(const chunk_reader&) = delete;
+    ~chunk_reader();
+    auto operator =(const chunk_reader&) -> chunk_reader& = delete;
+
+    auto next() -> std::span<const std::byte>;
+
+    auto fill() noexcept -> void;
+    auto read_some(std::byte* data, size_type count) noexcept -> ::ssize_t;
+    auto release() noexcept -> void;
+    auto wait_for(slot& target, size_type sequence) const noexcept -> bool;
+};
+
+inline chunk_reader::chunk_reader(int descriptor, size_type chunk_size, size_type depth) :
+    descriptor{ descriptor },
+    chunk_size{ chunk_size },
+    slots(std::max<size_type>(depth, 2))
+{
+    contract;
+        pre(chunk_size > 0);
+
+    for (size_type i = 0; i < slots.size; ++i)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+        slots[i].storage.resize(uninitialized, chunk_size);
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    ::posix_fadvise(descriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    struct ::stat status{};
+    pollable = ::fstat(descriptor, &status) == 0 and not S_ISREG(status.st_mode) and not S_ISBLK(status.st_mode);
+#ifdef __linux__
+    if (::pipe2(wake, O_CLOEXEC) != 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), "pipe2" };
+    }
+#else
+    if (::pipe(wake) != 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), "pipe" };
+    }
+    ::fcntl(wake[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(wake[1], F_SETFD, FD_CLOEXEC);
+#endif
+    try
+    {
+        filler = std::thread{ [this] { fill(); } };
+    }
+    catch (...)
+    {
+        // the destructor does not run for a half built reader, so the wake up pipe is closed here.
+        ::close(wake[0]);
+        ::close(wake[1]);
+        throw;
+    }
+};
+
+/*
+    Stops the filler wherever it is, without reading the rest of the file.
+*/
+inline chunk_reader::~chunk_reader()
+{
+    stopping.store(true);
+    for (slot& target : slots)
+    {
+        target.sequence.store(std::numeric_limits<size_type>::max(), std::memory_order_release);
+        target.sequence.notify_all();
+    }
+    const std::byte signal{};
+    (void)::write(wake[1], &signal, 1);
+    filler.join();
+    ::close(wake[0]);
+    ::close(wake[1]);
+};
+
+/*
+    Sleeps until target's sequence reaches sequence, returning false if the reader is stopped first.
+*/
+inline auto chunk_reader::wait_for(slot& target, size_type sequence) const noexcept -> bool
+{
+    for (size_type current = target.sequence.load(std::memory_order_acquire); current != sequence; current = target.sequence.load(std::memory_order_acquire))
+    {
+        if (stopping.load())
+        {
+            return false;
+        }
+        target.sequence.wait(current, std::memory_order_acquire);
+    }
+    return true;
+};
+
+/*
+    The background thread. Fills each slot as it comes free until the end of the file or an error,
+    retrying short reads and EINTR so that only the last chunk can come back short.
+*/
+inline auto chunk_reader::fill() noexcept -> void
+{
+    for (size_type filling = 0; not stopping.load(); ++filling)
+    {
+        slot& target = slots[filling % slots.size];
+        if (not wait_for(target, filling))
+        {
+            return;
+        }
+
+        std::byte* data = std::to_address(target.storage.data);
+        target.filled = 0;
+        while (target.filled < chunk_size)
+        {
+            const ::ssize_t result = read_some(data + target.filled, chunk_size - target.filled);
+            if (result < 0 and errno == EINTR)
+            {
+                continue;
+            }
+            if (stopping.load())
+            {
+                return;
+            }
+            if (result < 0)
+            {
+                target.failure = std::make_exception_ptr(std::system_error{ errno, std::generic_category(), "read" });
+                target.last = true;
+                break;
+            }
+            if (result == 0)
+            {
+                target.last = true;
+                break;
+            }
+            target.filled += static_cast<size_type>(result);
+        }
+
+        target.sequence.store(filling + 1, std::memory_order_release);
+        target.sequence.notify_all();
+        if (target.last)
+        {
+            return;
+        }
+    }
+};
+
+/*
+    Waits until the descriptor has data, or the reader is being destroyed, then reads it.
+*/
+inline auto chunk_reader::read_some(std::byte* data, size_type count) noexcept -> ::ssize_t
+{
+    if (not pollable)
+    {
+        return ::read(descriptor, data, count);
+    }
+
+    ::pollfd events[2] = { { descriptor, POLLIN, 0 }, { wake[0], POLLIN, 0 } };
+    if (::poll(events, 2, -1) < 0)
+    {
+        return -1;
+    }
+    if (events[1].revents != 0)
+    {
+        return 0;
+    }
+    return ::read(descriptor, data, count);
+};
+
+/*
+    Hands the slot the consumer holds back to the filler.
+*/
+inline auto chunk_reader::release() noexcept -> void
+{
+    if (holding)
+    {
+        slot& target = slots[(position - 1) % slots.size];
+        target.sequence.store(position - 1 + slots.size, std::memory_order_release);
+        target.sequence.notify_all();
+        holding = false;
+    }
+};
+
+/*
+    Blocks until the next chunk is filled and returns its bytes, or an empty span once the file is exhausted.
+    Every chunk but the last is chunk_size bytes long.
+*/
+inline auto chunk_reader::next() -> std::span<const std::byte>
+{
+    release();
+    if (finished)
+    {
+        return {};
+    }
+
+    slot& target = slots[position % slots.size];
+    wait_for(target, position + 1);
+    ++position;
+    holding = true;
+    finished = target.last;
+    if (target.failure)
+    {
+        std::rethrow_exception(target.failure);
+    }
+    return { std::to_address(target.storage.data), target.filled };
+};
+#endif
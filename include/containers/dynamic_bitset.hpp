@@ -0,0 +1,594 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A runtime sized set of bits, stored in a dynamic_buffer of 64 bit words.
+    Can only change size when explicitly resized, like dynamic_buffer.
+
+    The bulk operations, and, or, xor and and_not between bitsets of the same size, run a plain loop over the
+    words through restrict pointers, which compilers vectorize at full width. count() sums the words with
+    the popcount instruction when the target has one, otherwise with a bit slicing kernel that vectorizes too.
+    find_first() and find_next() skip over whole zero words and find the bit within one with std::countr_zero.
+    rank_select_index answers how many bits are set before a position, and where the n-th set bit is.
+    Every bit past size in the last word is zero.
+*/
+
+#ifndef CONTAINERS_HAS_POPCNT
+#if defined(__POPCNT__) or defined(_MSC_VER) or defined(__aarch64__) or defined(_M_ARM64)
+#define CONTAINERS_HAS_POPCNT 1
+#else
+#define CONTAINERS_HAS_POPCNT 0
+#endif
+#endif
+
+/*
+    The number of set bits in count words.
+    Without a popcount instruction std::popcount becomes a library call per word, so the words are instead
+    counted a byte at a time with shifts and masks, summed for up to 31 words before the bytes could overflow.
+*/
+inline auto count_word_bits(const std::uint64_t* words, std::size_t count) noexcept -> std::size_t
+{
+    std::size_t total = 0;
+#if CONTAINERS_HAS_POPCNT
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        total += std::popcount(words[i]);
+    }
+#else
+    constexpr std::uint64_t pairs = 0x5555'5555'5555'5555;
+    constexpr std::uint64_t nibbles = 0x3333'3333'3333'3333;
+    constexpr std::uint64_t bytes = 0x0F0F'0F0F'0F0F'0F0F;
+    constexpr std::uint64_t shorts = 0x00FF'00FF'00FF'00FF;
+    for (std::size_t i = 0; i < count; )
+    {
+        const std::size_t end = std::min(count, i + 31);
+        std::uint64_t sums = 0;
+        for (; i < end; ++i)
+        {
+            std::uint64_t word = words[i];
+            word -= (word >> 1) & pairs;
+            word = (word & nibbles) + ((word >> 2) & nibbles);
+            sums += (word + (word >> 4)) & bytes;
+        }
+        sums = (sums & shorts) + ((sums >> 8) & shorts);
+        total += (sums * 0x0001'0001'0001'0001) >> 48;
+    }
+#endif
+    return total;
+};
+
+/*
+    The position of the set bit that has rank bits set below it, which must exist.
+    Finds the byte holding it from the running byte counts, then the bit within the byte.
+*/
+constexpr auto select_word_bit(std::uint64_t word, std::size_t rank) noexcept -> std::size_t
+{
+    std::uint64_t counts = word - ((word >> 1) & 0x5555'5555'5555'5555);
+    counts = (counts & 0x3333'3333'3333'3333) + ((counts >> 2) & 0x3333'3333'3333'3333);
+    counts = (counts + (counts >> 4)) & 0x0F0F'0F0F'0F0F'0F0F;
+    // byte i now holds the number of set bits in bytes 0 through i.
+    const std::uint64_t running = counts * 0x0101'0101'0101'0101;
+
+    std::size_t byte = 0;
+    while (((running >> (byte * 8)) & 0xFF) <= rank)
+    {
+        ++byte;
+    }
+    if (byte > 0)
+    {
+        rank -= (running >> (byte * 8 - 8)) & 0xFF;
+    }
+
+    std::uint64_t bits = (word >> (byte * 8)) & 0xFF;
+    for (; rank > 0; --rank)
+    {
+        bits &= bits - 1;
+    }
+    return byte * 8 + std::countr_zero(bits);
+};
+
+/*
+    destination = operation(destination, source) word by word. The pointers must not overlap.
+*/
+template <typename Op>
+auto transform_words(std::uint64_t* __restrict destination, const std::uint64_t* __restrict source, std::size_t count, Op operation) noexcept -> void
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        destination[i] = operation(destination[i], source[i]);
+    }
+};
+
+template <typename Op>
+auto transform_words(std::uint64_t* __restrict destination, const std::uint64_t* __restrict left, const std::uint64_t* __restrict right, std::size_t count, Op operation) noexcept -> void
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        destination[i] = operation(left[i], right[i]);
+    }
+};
+
+struct bit_and_not
+{
+    constexpr auto operator ()(std::uint64_t left, std::uint64_t right) const noexcept -> std::uint64_t
+    {
+        return left & ~right;
+    };
+};
+
+template <typename A = std::allocator<std::uint64_t>>
+struct dynamic_bitset
+{
+    using word_type = std::uint64_t;
+    using traits = typename std::allocator_traits<A>::template rebind_traits<word_type>;
+    using allocator_type = typename traits::allocator_type;
+    using size_type = std::size_t;
+    using words_type = dynamic_buffer<word_type, allocator_type>;
+
+    static constexpr size_type word_bits = 64;
+    static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+    size_type size = 0;
+    words_type words = {};
+
+    dynamic_bitset() = default;
+    dynamic_bitset(const dynamic_bitset& other) = default;
+    dynamic_bitset(dynamic_bitset&& other) noexcept;
+    auto operator =(dynamic_bitset other) noexcept -> dynamic_bitset&;
+
+    explicit dynamic_bitset(const allocator_type& allocator) noexcept;
+    explicit dynamic_bitset(size_type size, bool value = false);
+    dynamic_bitset(std::allocator_arg_t, const allocator_type& allocator, size_type size, bool value = false);
+
+    static constexpr auto words_for(size_type bits) noexcept -> size_type
+    {
+        return (bits + word_bits - 1) / word_bits;
+    };
+
+    auto operator [](size_type index) const noexcept -> bool
+    {
+        return test(index);
+    };
+    auto test(size_type index) const noexcept -> bool;
+    auto set(size_type index, bool value = true) noexcept -> void;
+    auto reset(size_type index) noexcept -> void;
+    auto flip(size_type index) noexcept -> void;
+
+    auto set() noexcept -> void;
+    auto reset() noexcept -> void;
+    auto flip() noexcept -> void;
+
+    auto operator &=(const dynamic_bitset& other) noexcept -> dynamic_bitset&;
+    auto operator |=(const dynamic_bitset& other) noexcept -> dynamic_bitset&;
+    auto operator ^=(const dynamic_bitset& other) noexcept -> dynamic_bitset&;
+    auto and_not(const dynamic_bitset& other) noexcept -> dynamic_bitset&;
+
+    auto count() const noexcept -> size_type;
+    auto any() const noexcept -> bool;
+    auto none() const noexcept -> bool
+    {
+        return not any();
+    };
+    auto all() const noexcept -> bool;
+
+    auto find_first() const noexcept -> size_type;
+    auto find_next(size_type index) const noexcept -> size_type;
+    auto find_from(size_type index) const noexcept -> size_type;
+
+    auto resize(size_type size, bool value = false) -> void;
+    auto release_storage() noexcept -> void;
+    auto clear_tail() noexcept -> void;
+};
+
+template <typename A>
+auto swap(dynamic_bitset<A>& left, dynamic_bitset<A>& right) noexcept -> void
+{
+    using std::swap;
+
+    swap(left.size, right.size);
+    swap(left.words, right.words);
+};
+
+template <typename A>
+dynamic_bitset<A>::dynamic_bitset(dynamic_bitset&& other) noexcept :
+    size{ std::exchange(other.size, 0) },
+    words{ std::move(other.words) }
+{};
+
+template <typename A>
+auto dynamic_bitset<A>::operator =(dynamic_bitset other) noexcept -> dynamic_bitset&
+{
+    swap(*this, other);
+    return *this;
+};
+
+template <typename A>
+dynamic_bitset<A>::dynamic_bitset(const allocator_type& allocator) noexcept :
+    words{ allocator }
+{};
+
+template <typename A>
+dynamic_bitset<A>::dynamic_bitset(size_type size, bool value) :
+    dynamic_bitset{ std::allocator_arg, allocator_type{}, size, value }
+{};
+
+template <typename A>
+dynamic_bitset<A>::dynamic_bitset(std::allocator_arg_t, const allocator_type& allocator, size_type size, bool value) :
+    size{ size },
+    words{ std::allocator_arg, allocator, words_for(size), value ? ~word_type{ 0 } : word_type{ 0 } }
+{
+    clear_tail();
+};
+
+template <typename A>
+auto dynamic_bitset<A>::test(size_type index) const noexcept -> bool
+{
+    check_index(index, size);
+
+    return (words[index / word_bits] >> (index % word_bits)) & 1;
+};
+
+template <typename A>
+auto dynamic_bitset<A>::set(size_type index, bool value) noexcept -> void
+{
+    check_index(index, size);
+
+    const word_type bit = word_type{ 1 } << (index % word_bits);
+    word_type& word = words[index / word_bits];
+    word = value ? word | bit : word & ~bit;
+};
+
+template <typename A>
+auto dynamic_bitset<A>::reset(size_type index) noexcept -> void
+{
+    set(index, false);
+};
+
+template <typename A>
+auto dynamic_bitset<A>::flip(size_type index) noexcept -> void
+{
+    check_index(index, size);
+
+    words[index / word_bits] ^= word_type{ 1 } << (index % word_bits);
+};
+
+template <typename A>
+auto dynamic_bitset<A>::set() noexcept -> void
+{
+    std::fill_n(std::to_address(words.data), words.size, ~word_type{ 0 });
+    clear_tail();
+};
+
+template <typename A>
+auto dynamic_bitset<A>::reset() noexcept -> void
+{
+    std::fill_n(std::to_address(words.data), words.size, word_type{ 0 });
+};
+
+template <typename A>
+auto dynamic_bitset<A>::flip() noexcept -> void
+{
+    std::transform(std::to_address(words.data), std::to_address(words.data) + words.size, std::to_address(words.data), std::bit_not<>{});
+    clear_tail();
+};
+
+/*
+    Combining a bitset with itself would break the restrict promise of the kernels, so those cases are done here.
+*/
+template <typename A>
+auto dynamic_bitset<A>::operator &=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+{
+    contract;
+        pre(size == other.size);
+
+    if (this != &other)
+    {
+        transform_words(std::to_address(words.data), std::to_address(other.words.data), words.size, std::bit_and<>{});
+    }
+    return *this;
+};
+
+template <typename A>
+auto dynamic_bitset<A>::operator |=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+{
+    contract;
+        pre(size == other.size);
+
+    if (this != &other)
+    {
+        transform_words(std::to_address(words.data), std::to_address(other.words.data), words.size, std::bit_or<>{});
+    }
+    return *this;
+};
+
+template <typename A>
+auto dynamic_bitset<A>::operator ^=(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+{
+    contract;
+        pre(size == other.size);
+
+    if (this == &other)
+    {
+        reset();
+    }
+    else
+    {
+        transform_words(std::to_address(words.data), std::to_address(other.words.data), words.size, std::bit_xor<>{});
+    }
+    return *this;
+};
+
+/*
+    Clears every bit that is set in other, this & ~other, in one pass.
+*/
+template <typename A>
+auto dynamic_bitset<A>::and_not(const dynamic_bitset& other) noexcept -> dynamic_bitset&
+{
+    contract;
+        pre(size == other.size);
+
+    if (this == &other)
+    {
+        reset();
+    }
+    else
+    {
+        transform_words(std::to_address(words.data), std::to_address(other.words.data), words.size, bit_and_not{});
+    }
+    return *this;
+};
+
+template <typename A>
+auto dynamic_bitset<A>::count() const noexcept -> size_type
+{
+    return count_word_bits(std::to_address(words.data), words.size);
+};
+
+template <typename A>
+auto dynamic_bitset<A>::any() const noexcept -> bool
+{
+    return std::any_of(words.begin(), words.end(), [](word_type word) { return word != 0; });
+};
+
+template <typename A>
+auto dynamic_bitset<A>::all() const noexcept -> bool
+{
+    return count() == size;
+};
+
+/*
+    The index of the first set bit at or after index, or npos.
+*/
+template <typename A>
+auto dynamic_bitset<A>::find_from(size_type index) const noexcept -> size_type
+{
+    if (index >= size)
+    {
+        return npos;
+    }
+
+    size_type word = index / word_bits;
+    word_type bits = words[word] & (~word_type{ 0 } << (index % word_bits));
+    while (bits == 0)
+    {
+        if (++word == words.size)
+        {
+            return npos;
+        }
+        bits = words[word];
+    }
+    return word * word_bits + std::countr_zero(bits);
+};
+
+template <typename A>
+auto dynamic_bitset<A>::find_first() const noexcept -> size_type
+{
+    return find_from(0);
+};
+
+/*
+    The index of the first set bit after index, or npos, so that
+        for (auto i = bits.find_first(); i != bits.npos; i = bits.find_next(i))
+    visits every set bit in order.
+*/
+template <typename A>
+auto dynamic_bitset<A>::find_next(size_type index) const noexcept -> size_type
+{
+    return index == npos ? npos : find_from(index + 1);
+};
+
+/*
+    New bits are set to value. Has the strong exception guarantee.
+*/
+template <typename A>
+auto dynamic_bitset<A>::resize(size_type new_size, bool value) -> void
+{
+    const word_type fill = value ? ~word_type{ 0 } : word_type{ 0 };
+    if (new_size > size and size % word_bits != 0)
+    {
+        // the new bits in the old last word are zero, so setting them is an or.
+        words.resize(words_for(new_size), fill);
+        words[size / word_bits] |= fill << (size % word_bits);
+    }
+    else
+    {
+        words.resize(words_for(new_size), fill);
+    }
+    size = new_size;
+    clear_tail();
+};
+
+template <typename A>
+auto dynamic_bitset<A>::release_storage() noexcept -> void
+{
+    words.release_storage();
+    size = 0;
+};
+
+/*
+    Zeroes the bits of the last word past size, which the whole word operations may have set.
+*/
+template <typename A>
+auto dynamic_bitset<A>::clear_tail() noexcept -> void
+{
+    if (size % word_bits != 0)
+    {
+        words[words.size - 1] &= ~word_type{ 0 } >> (word_bits - size % word_bits);
+    }
+};
+
+template <typename A>
+auto operator ==(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right) noexcept -> bool
+{
+    return left.size == right.size and equal_elements(std::to_address(left.words.data), std::to_address(right.words.data), left.words.size);
+};
+
+/*
+    The binary operators write the result straight into new storage, rather than copying one side first.
+*/
+template <typename A, typename Op>
+auto combine_bitsets(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right, Op operation) -> dynamic_bitset<A>
+{
+    contract;
+        pre(left.size == right.size);
+
+    dynamic_bitset<A> result{ left.words.allocator };
+    result.words.resize(uninitialized, left.words.size);
+    result.size = left.size;
+    transform_words(std::to_address(result.words.data), std::to_address(left.words.data), std::to_address(right.words.data), left.words.size, operation);
+    return result;
+};
+
+template <typename A>
+auto operator &(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right) -> dynamic_bitset<A>
+{
+    return combine_bitsets(left, right, std::bit_and<>{});
+};
+
+template <typename A>
+auto operator |(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right) -> dynamic_bitset<A>
+{
+    return combine_bitsets(left, right, std::bit_or<>{});
+};
+
+template <typename A>
+auto operator ^(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right) -> dynamic_bitset<A>
+{
+    return combine_bitsets(left, right, std::bit_xor<>{});
+};
+
+template <typename A>
+auto and_not(const dynamic_bitset<A>& left, const dynamic_bitset<A>& right) -> dynamic_bitset<A>
+{
+    return combine_bitsets(left, right, bit_and_not{});
+};
+
+/*
+    A counting index over a dynamic_bitset, for rank, the number of set bits before a position,
+    and select, the position of the n-th set bit.
+
+    Keeps the number of set bits before every 512 bit block, one cache line of words, so rank is a lookup
+    and a popcount of at most 8 words, and select is a binary search over the blocks followed by a scan
+    of one block. Takes about 12.5% of the bitset's size. Refers to the bitset, and must be rebuilt
+    whenever the bitset is modified.
+*/
+template <typename A = std::allocator<std::uint64_t>>
+struct rank_select_index
+{
+    using bitset_type = dynamic_bitset<A>;
+    using size_type = std::size_t;
+    using counts_type = dynamic_buffer<std::uint64_t, typename std::allocator_traits<A>::template rebind_alloc<std::uint64_t>>;
+
+    static constexpr size_type block_words = 8;
+    static constexpr size_type block_bits = block_words * bitset_type::word_bits;
+    static constexpr size_type npos = bitset_type::npos;
+
+    const bitset_type* bits = nullptr;
+    // counts[i] is the number of set bits before block i, the last entry the number in the whole bitset.
+    counts_type counts = {};
+
+    rank_select_index() = default;
+    explicit rank_select_index(const bitset_type& bits);
+
+    auto rank(size_type index) const noexcept -> size_type;
+    auto select(size_type rank) const noexcept -> size_type;
+
+    auto total() const noexcept -> size_type
+    {
+        return counts.size == 0 ? 0 : counts[counts.size - 1];
+    };
+};
+
+template <typename A>
+rank_select_index<A>::rank_select_index(const bitset_type& bits) :
+    bits{ &bits },
+    counts{ uninitialized, (bits.words.size + block_words - 1) / block_words + 1 }
+{
+    const std::uint64_t* words = std::to_address(bits.words.data);
+    std::uint64_t total = 0;
+    for (size_type block = 0; block + 1 < counts.size; ++block)
+    {
+        counts[block] = total;
+        const size_type first = block * block_words;
+        total += count_word_bits(words + first, std::min(block_words, bits.words.size - first));
+    }
+    counts[counts.size - 1] = total;
+};
+
+/*
+    The number of set bits before index, which may be the size of the bitset.
+*/
+template <typename A>
+auto rank_select_index<A>::rank(size_type index) const noexcept -> size_type
+{
+    contract;
+        pre(index <= bits->size);
+
+    const std::uint64_t* words = std::to_address(bits->words.data);
+    const size_type block = index / block_bits;
+    const size_type word = index / bitset_type::word_bits;
+
+    size_type result = counts[block] + count_word_bits(words + block * block_words, word - block * block_words);
+    if (index % bitset_type::word_bits != 0)
+    {
+        result += std::popcount(words[word] & (~std::uint64_t{ 0 } >> (bitset_type::word_bits - index % bitset_type::word_bits)));
+    }
+    return result;
+};
+
+/*
+    The index of the set bit with rank set bits before it, or npos if there are not that many.
+*/
+template <typename A>
+auto rank_select_index<A>::select(size_type rank) const noexcept -> size_type
+{
+    if (rank >= total())
+    {
+        return npos;
+    }
+
+    // the last block whose count does not exceed rank holds the bit.
+    const size_type block = std::upper_bound(counts.begin(), counts.end(), rank) - counts.begin() - 1;
+    const std::uint64_t* words = std::to_address(bits->words.data);
+    rank -= counts[block];
+    for (size_type word = block * block_words; ; ++word)
+    {
+        const size_type ones = std::popcount(words[word]);
+        if (rank < ones)
+        {
+            return word * bitset_type::word_bits + select_word_bit(words[word], rank);
+        }
+        rank -= ones;
+    }
+};
@@ -1,22 +1,81 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
 #include <initializer_list>
 #include <compare>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
-#include "contract.hpp"
+#include "checking.hpp"
+#include "element_compare.hpp"
+#include "parallel.hpp"
 
 /*
     A buffer whose length is decided at runtime.
-    Can only change size when explicitly resized, and will always reallocate.
+    Can only change size when explicitly resized, and only reallocates when growing past its capacity.
+
+    Allocators may opt in to cheaper resizing by providing any of
+        allocate_at_least(count) -> { pointer, size_type }
+            the returned block may hold more than count elements, as in C++23.
+        expand(pointer, capacity, count) -> size_type
+            grows or shrinks the block without moving it, returning the new capacity, or 0 on failure.
+        reallocate(pointer, capacity, count) -> { pointer, size_type }
+            moves the block like realloc, only used for trivially relocatable elements.
+    and may watch what the buffer does with its elements by providing any of
+        record_copies(count), record_moves(count)
+            count elements were copied or moved into the buffer's storage.
+        record_reallocation()
+            the buffer moved its elements to a new block, growing or shrinking.
+
+    Every constructor has an allocator extended form taking std::allocator_arg and the allocator first,
+    and assignment follows the allocator's propagate_on_container traits.
+
+    Constructing, copying and resizing also have overloads taking parallel, which build the elements
+    on several threads. Those call the allocator's construct, destroy and record_copies concurrently.
 */
 
+/*
+    Types that can be moved to a new address with a plain memcpy, leaving the old
+    storage to be deallocated without running a destructor.
+    Specialize for types that own resources but do not point into themselves.
+*/
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T> and std::is_trivially_destructible_v<T>> {};
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
 struct uninitialized_t
 {
     explicit uninitialized_t() = default;
 };
 constexpr uninitialized_t uninitialized{};
 
+/*
+    Select the constructors that build each element from a callable, exactly once and in place.
+*/
+struct from_generator_t
+{
+    explicit from_generator_t() = default;
+};
+constexpr from_generator_t from_generator{};
+
+struct from_output_t
+{
+    explicit from_output_t() = default;
+};
+constexpr from_output_t from_output{};
+
+template <typename A>
+struct is_polymorphic_allocator : std::false_type {};
+template <typename T>
+struct is_polymorphic_allocator<std::pmr::polymorphic_allocator<T>> : std::true_type {};
+
 template <typename T, typename A = std::allocator<T>>
 struct dynamic_buffer
 {
@@ -26,7 +85,43 @@ struct dynamic_buffer
     using size_type = typename traits::size_type;
     using pointer = typename traits::pointer;
 
+    /*
+        polymorphic_allocator only customizes construct to pass itself to types that take an allocator,
+        for anything else its construct and destroy are the plain ones.
+    */
+    static constexpr bool is_plainly_constructed = is_polymorphic_allocator<allocator_type>::value and
+        not std::uses_allocator_v<value_type, allocator_type>;
+
+    /*
+        Element operations that may bypass the allocator and be done in bulk.
+        Only valid when the allocator does not customize construct or destroy.
+    */
+    static constexpr bool is_bulk_copyable = std::is_trivially_copyable_v<value_type> and (is_plainly_constructed or
+        not requires (allocator_type& allocator, value_type* pointer, const value_type& value) { allocator.construct(pointer, value); });
+    static constexpr bool is_bulk_destructible = std::is_trivially_destructible_v<value_type> and (is_plainly_constructed or
+        not requires (allocator_type& allocator, value_type* pointer) { allocator.destroy(pointer); });
+    static constexpr bool is_bulk_relocatable = is_trivially_relocatable_v<value_type> and (is_plainly_constructed or (
+        not requires (allocator_type& allocator, value_type* pointer, value_type&& value) { allocator.construct(pointer, std::move(value)); } and
+        not requires (allocator_type& allocator, value_type* pointer) { allocator.destroy(pointer); }));
+    static constexpr bool is_zero_fillable = std::is_scalar_v<value_type> and not std::is_member_pointer_v<value_type> and (is_plainly_constructed or
+        not requires (allocator_type& allocator, value_type* pointer) { allocator.construct(pointer); });
+
+    template <typename... Args>
+    static constexpr auto construct_elements(allocator_type& allocator, pointer destination, size_type count, Args&&... arguments) -> void;
+    static constexpr auto copy_elements(allocator_type& allocator, pointer destination, const value_type* source, size_type count) -> void;
+    static constexpr auto relocate_elements(allocator_type& allocator, pointer destination, pointer source, size_type count) -> void;
+    static constexpr auto destroy_elements(allocator_type& allocator, pointer destination, size_type count) -> void;
+    static constexpr auto allocate_storage(allocator_type& allocator, size_type& capacity) -> pointer;
+    static constexpr auto deallocate_storage(allocator_type& allocator, pointer data, size_type capacity) -> void;
+    static constexpr auto record_copies(allocator_type& allocator, size_type count) noexcept -> void;
+    static constexpr auto record_moves(allocator_type& allocator, size_type count) noexcept -> void;
+    static constexpr auto record_reallocation(allocator_type& allocator) noexcept -> void;
+
+    // the smallest slice worth a thread of its own.
+    static constexpr size_type parallel_grain = std::max<size_type>((size_type{ 1 } << 20) / sizeof(value_type), 1);
+
     size_type size = 0;
+    size_type capacity = 0;
     [[no_unique_address]] allocator_type allocator = {};
     pointer data = nullptr;
 
@@ -34,13 +129,39 @@ struct dynamic_buffer
     constexpr dynamic_buffer(const dynamic_buffer& other);
     constexpr dynamic_buffer(dynamic_buffer&& other) noexcept;
     constexpr ~dynamic_buffer();
-    constexpr auto operator =(dynamic_buffer other) noexcept -> dynamic_buffer&;
+    constexpr auto operator =(const dynamic_buffer& other) -> dynamic_buffer&;
+    constexpr auto operator =(dynamic_buffer&& other) noexcept(traits::propagate_on_container_move_assignment::value or traits::is_always_equal::value) -> dynamic_buffer&;
 
     constexpr dynamic_buffer(std::initializer_list<value_type> init);
     template <typename... Args>
     constexpr dynamic_buffer(size_type size, Args&&... arguments);
     constexpr dynamic_buffer(uninitialized_t, size_type size);
     constexpr dynamic_buffer(pointer data, size_type size);
+    template <typename F>
+    constexpr dynamic_buffer(from_generator_t, size_type count, F&& generator);
+    template <typename F>
+    constexpr dynamic_buffer(from_output_t, size_type count, F&& writer);
+
+    constexpr explicit dynamic_buffer(const allocator_type& allocator) noexcept;
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator) noexcept;
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, const dynamic_buffer& other);
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, dynamic_buffer&& other);
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, std::initializer_list<value_type> init);
+    template <typename... Args>
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size, Args&&... arguments);
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, uninitialized_t, size_type size);
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, pointer data, size_type size);
+    template <typename F>
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, from_generator_t, size_type count, F&& generator);
+    template <typename F>
+    constexpr dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, from_output_t, size_type count, F&& writer);
+
+    template <typename... Args>
+    dynamic_buffer(parallel_t policy, size_type size, Args&&... arguments);
+    dynamic_buffer(parallel_t policy, const dynamic_buffer& other);
+    template <typename... Args>
+    dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, parallel_t policy, size_type size, Args&&... arguments);
+    dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, parallel_t policy, const dynamic_buffer& other);
 
     constexpr auto operator [](size_type index)	      & -> value_type&;
     constexpr auto operator [](size_type index) const & -> const value_type&;
@@ -49,6 +170,16 @@ struct dynamic_buffer
     template <typename... Args>
     constexpr auto resize(size_type size, Args&&... arguments) -> void;
     constexpr auto resize(uninitialized_t, size_type size) -> void;
+    template <typename Op>
+    constexpr auto resize_and_overwrite(size_type count, Op op) -> void;
+    template <typename... Args>
+    auto resize(parallel_t policy, size_type size, Args&&... arguments) -> void;
+    constexpr auto shrink_to_fit() -> void;
+
+    constexpr auto expand_storage(size_type count) -> bool;
+    constexpr auto reallocate_storage(size_type count) -> void;
+    constexpr auto release_storage() -> void;
+    constexpr auto take_storage(dynamic_buffer& other) noexcept -> void;
 
     struct iterator
     {
@@ -143,6 +274,45 @@ struct dynamic_buffer
         constexpr auto operator ->() const -> pointer;
     };
 
+    /*
+        Handed to the writer of the from_output constructor. Like std::back_insert_iterator, every value
+        assigned through it is constructed in the buffer's next free slot, and incrementing does nothing.
+        Writing past the capacity throws std::length_error, whatever the checking policy.
+    */
+    struct construct_iterator
+    {
+        using value_type = void;
+        using reference_type = void;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::output_iterator_tag;
+
+        dynamic_buffer* buffer = nullptr;
+
+        template <typename U>
+            requires (not std::same_as<std::remove_cvref_t<U>, construct_iterator>)
+        constexpr auto operator =(U&& value) -> construct_iterator&
+        {
+            emplace(std::forward<U>(value));
+            return *this;
+        };
+        template <typename... Args>
+        constexpr auto emplace(Args&&... arguments) -> void;
+
+        constexpr auto operator *() noexcept -> construct_iterator&
+        {
+            return *this;
+        };
+        constexpr auto operator ++() noexcept -> construct_iterator&
+        {
+            return *this;
+        };
+        constexpr auto operator ++(int) noexcept -> construct_iterator
+        {
+            return *this;
+        };
+    };
+
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
@@ -203,6 +373,7 @@ constexpr auto swap(dynamic_buffer<T, A>& left, dynamic_buffer<T, A>& right) noe
     using std::swap;
 
     swap(left.size, right.size);
+    swap(left.capacity, right.capacity);
     swap(left.data, right.data);
 
     if constexpr (dynamic_buffer<T, A>::traits::propagate_on_container_swap::value)
@@ -212,102 +383,553 @@ constexpr auto swap(dynamic_buffer<T, A>& left, dynamic_buffer<T, A>& right) noe
 };
 
 template <typename T, typename A>
-constexpr dynamic_buffer<T, A>::dynamic_buffer(const dynamic_buffer& other) :
-    size{ other.size },
-    allocator{ traits::select_on_container_copy_construction(other.allocator) },
-    data{ traits::allocate(allocator, size) }
+template <typename... Args>
+constexpr auto dynamic_buffer<T, A>::construct_elements(allocator_type& allocator, pointer destination, size_type count, Args&&... arguments) -> void
+{
+    if constexpr (sizeof...(Args) == 0 and is_zero_fillable)
+    {
+        if !consteval
+        {
+            if (count > 0)
+            {
+                std::memset(std::to_address(destination), 0, count * sizeof(value_type));
+            }
+            return;
+        }
+    }
+    else if constexpr (sizeof...(Args) == 1 and (std::same_as<std::remove_cvref_t<Args>, value_type> and ...) and is_bulk_copyable)
+    {
+        if !consteval
+        {
+            const value_type value(std::forward<Args>(arguments)...);
+            std::uninitialized_fill_n(std::to_address(destination), count, value);
+            return;
+        }
+    }
+
+    size_type i = 0;
+    try
+    {
+        for (; i < count; ++i)
+        {
+            traits::construct(allocator, destination + i, std::forward<Args>(arguments)...);
+        }
+    }
+    catch (...)
+    {
+        destroy_elements(allocator, destination, i);
+        throw;
+    }
+};
+
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::copy_elements(allocator_type& allocator, pointer destination, const value_type* source, size_type count) -> void
+{
+    record_copies(allocator, count);
+
+    if constexpr (is_bulk_copyable)
+    {
+        if !consteval
+        {
+            if (count > 0)
+            {
+                std::memcpy(std::to_address(destination), source, count * sizeof(value_type));
+            }
+            return;
+        }
+    }
+
+    size_type i = 0;
+    try
+    {
+        for (; i < count; ++i)
+        {
+            traits::construct(allocator, destination + i, source[i]);
+        }
+    }
+    catch (...)
+    {
+        destroy_elements(allocator, destination, i);
+        throw;
+    }
+};
+
+/*
+    Moves count elements into uninitialized destination and ends their lifetime in source.
+    Falls back to copying when moving could throw, so a failure leaves source untouched.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::relocate_elements(allocator_type& allocator, pointer destination, pointer source, size_type count) -> void
+{
+    if constexpr (is_bulk_relocatable or std::is_nothrow_move_constructible_v<value_type> or not std::is_copy_constructible_v<value_type>)
+    {
+        record_moves(allocator, count);
+    }
+    else
+    {
+        record_copies(allocator, count);
+    }
+
+    if constexpr (is_bulk_relocatable)
+    {
+        if !consteval
+        {
+            if (count > 0)
+            {
+                std::memcpy(static_cast<void*>(std::to_address(destination)), static_cast<const void*>(std::to_address(source)), count * sizeof(value_type));
+            }
+            return;
+        }
+    }
+
+    size_type i = 0;
+    try
+    {
+        for (; i < count; ++i)
+        {
+            traits::construct(allocator, destination + i, std::move_if_noexcept(source[i]));
+        }
+    }
+    catch (...)
+    {
+        destroy_elements(allocator, destination, i);
+        throw;
+    }
+    destroy_elements(allocator, source, count);
+};
+
+/*
+    Allocates room for at least capacity elements and updates it to the amount actually received.
+    An empty request does not allocate.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::allocate_storage(allocator_type& allocator, size_type& capacity) -> pointer
+{
+    if (capacity == 0)
+    {
+        return nullptr;
+    }
+
+    if constexpr (requires { allocator.allocate_at_least(capacity); })
+    {
+        auto [data, count] = allocator.allocate_at_least(capacity);
+        capacity = count;
+        return data;
+    }
+    else
+    {
+        return traits::allocate(allocator, capacity);
+    }
+};
+
+/*
+    An empty block was never allocated, and some allocators reject a null pointer.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::deallocate_storage(allocator_type& allocator, pointer data, size_type capacity) -> void
 {
-    contract;
-        post(size == other.size);
+    if (data)
+    {
+        traits::deallocate(allocator, data, capacity);
+    }
+};
 
-    cond(data ? size > 0 : size == 0);
-    for (size_t i = 0; i < size; ++i)
+/*
+    Tell allocators that watch the buffer what it did, see the top of the file.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::record_copies(allocator_type& allocator, size_type count) noexcept -> void
+{
+    if constexpr (requires { allocator.record_copies(count); })
     {
-        traits::construct(allocator, data + i, *(other.data + i));
+        allocator.record_copies(count);
     }
 };
 
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::record_moves(allocator_type& allocator, size_type count) noexcept -> void
+{
+    if constexpr (requires { allocator.record_moves(count); })
+    {
+        allocator.record_moves(count);
+    }
+};
+
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::record_reallocation(allocator_type& allocator) noexcept -> void
+{
+    if constexpr (requires { allocator.record_reallocation(); })
+    {
+        allocator.record_reallocation();
+    }
+};
+
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::destroy_elements(allocator_type& allocator, pointer destination, size_type count) -> void
+{
+    if constexpr (is_bulk_destructible)
+    {
+        return;
+    }
+
+    for (size_type i = 0; i < count; ++i)
+    {
+        traits::destroy(allocator, destination + i);
+    }
+};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(const dynamic_buffer& other) :
+    dynamic_buffer{ std::allocator_arg, traits::select_on_container_copy_construction(other.allocator), other }
+{};
+
 template <typename T, typename A>
 constexpr dynamic_buffer<T, A>::dynamic_buffer(dynamic_buffer&& other) noexcept :
-    dynamic_buffer{}
+    allocator{ std::move(other.allocator) }
 {
-    swap(*this, other);
+    take_storage(other);
 };
 
 template <typename T, typename A>
 constexpr dynamic_buffer<T, A>::~dynamic_buffer()
 {
-    contract;
-        post(size == 0);
-        post(data == nullptr);
+    release_storage();
+    default_checking::check(size == 0 and capacity == 0 and data == nullptr);
+};
+
+/*
+    Reuses the existing storage when it is large enough and the allocator stays the same,
+    otherwise copies into new storage first, so a failure leaves the buffer untouched.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::operator =(const dynamic_buffer& other) -> dynamic_buffer&
+{
+    if (this == &other)
+    {
+        return *this;
+    }
 
-    for (size_t i = 0; i < size; ++i)
+    constexpr bool propagate = traits::propagate_on_container_copy_assignment::value;
+    if constexpr (is_bulk_copyable and is_bulk_destructible)
     {
-        traits::destroy(allocator, data + i);
+        if (other.size <= capacity and (not propagate or traits::is_always_equal::value or allocator == other.allocator))
+        {
+            if constexpr (propagate)
+            {
+                allocator = other.allocator;
+            }
+            copy_elements(allocator, data, std::to_address(other.data), other.size);
+            size = other.size;
+            return *this;
+        }
     }
 
-    traits::deallocate(allocator, data, size);
-    size = 0;
-    data = nullptr;
+    dynamic_buffer copy{ std::allocator_arg, propagate ? other.allocator : allocator, other };
+    release_storage();
+    if constexpr (propagate)
+    {
+        allocator = other.allocator;
+    }
+    take_storage(copy);
+    return *this;
 };
 
+/*
+    Takes the storage of other when the allocator propagates or the two allocators are equal,
+    otherwise moves the elements one by one into storage from this buffer's allocator.
+*/
 template <typename T, typename A>
-constexpr auto dynamic_buffer<T, A>::operator =(dynamic_buffer other) noexcept -> dynamic_buffer&
+constexpr auto dynamic_buffer<T, A>::operator =(dynamic_buffer&& other) noexcept(traits::propagate_on_container_move_assignment::value or traits::is_always_equal::value) -> dynamic_buffer&
 {
-    swap(*this, other);
+    if (this == &other)
+    {
+        return *this;
+    }
+
+    if constexpr (traits::propagate_on_container_move_assignment::value)
+    {
+        release_storage();
+        allocator = std::move(other.allocator);
+        take_storage(other);
+    }
+    else
+    {
+        if (traits::is_always_equal::value or allocator == other.allocator)
+        {
+            release_storage();
+            take_storage(other);
+        }
+        else
+        {
+            dynamic_buffer moved{ std::allocator_arg, allocator, std::move(other) };
+            release_storage();
+            take_storage(moved);
+        }
+    }
+
     return *this;
 };
 
 template <typename T, typename A>
 constexpr dynamic_buffer<T, A>::dynamic_buffer(std::initializer_list<value_type> init) :
-    size{ init.size() },
-    allocator{},
-    data{ traits::allocate(allocator, size) }
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, init }
+{};
+
+template <typename T, typename A>
+template <typename... Args>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(size_type size, Args&&... arguments) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, size, std::forward<Args>(arguments)... }
+{};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(uninitialized_t, size_type size) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, uninitialized, size }
+{};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(pointer data, size_type size) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, data, size }
+{};
+
+template <typename T, typename A>
+template <typename F>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(from_generator_t, size_type count, F&& generator) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, from_generator, count, std::forward<F>(generator) }
+{};
+
+template <typename T, typename A>
+template <typename F>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(from_output_t, size_type count, F&& writer) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, from_output, count, std::forward<F>(writer) }
+{};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(const allocator_type& allocator) noexcept :
+    allocator{ allocator }
+{};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator) noexcept :
+    allocator{ allocator }
+{};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, const dynamic_buffer& other) :
+    size{ other.size },
+    capacity{ other.size },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
 {
-    contract;
-        post(size == init.size());
+    default_checking::check(data ? size > 0 : size == 0);
+    try
+    {
+        copy_elements(this->allocator, data, std::to_address(other.data), size);
+    }
+    catch (...)
+    {
+        deallocate_storage(this->allocator, data, capacity);
+        throw;
+    }
+    default_checking::check(size == other.size);
+};
 
-    for (size_type i = 0; i < size; ++i)
+/*
+    Takes the storage of other when the allocators are equal, otherwise relocates its elements,
+    either way other is left empty.
+*/
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, dynamic_buffer&& other) :
+    allocator{ allocator }
+{
+    if (traits::is_always_equal::value or this->allocator == other.allocator)
     {
-        traits::construct(allocator, data + i, *(init.begin() + i));
+        take_storage(other);
+        return;
+    }
+
+    capacity = other.size;
+    data = allocate_storage(this->allocator, capacity);
+    try
+    {
+        relocate_elements(this->allocator, data, other.data, other.size);
     }
+    catch (...)
+    {
+        deallocate_storage(this->allocator, data, capacity);
+        capacity = 0;
+        data = nullptr;
+        throw;
+    }
+    size = other.size;
+    other.size = 0;
+    other.release_storage();
+};
+
+template <typename T, typename A>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, std::initializer_list<value_type> init) :
+    size{ init.size() },
+    capacity{ init.size() },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
+{
+    try
+    {
+        copy_elements(this->allocator, data, init.begin(), size);
+    }
+    catch (...)
+    {
+        deallocate_storage(this->allocator, data, capacity);
+        throw;
+    }
+    default_checking::check(size == init.size());
 };
 
 template <typename T, typename A>
 template <typename... Args>
-constexpr dynamic_buffer<T, A>::dynamic_buffer(size_type size, Args&&... arguments) :
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size, Args&&... arguments) :
     size{ size },
-    allocator{},
-    data{ traits::allocate(allocator, size) }
+    capacity{ size },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
 {
-    for (size_type i = 0; i < size; ++i)
+    try
+    {
+        construct_elements(this->allocator, data, size, std::forward<Args>(arguments)...);
+    }
+    catch (...)
     {
-        traits::construct(allocator, data + i, std::forward<Args>(arguments)...);
+        deallocate_storage(this->allocator, data, capacity);
+        throw;
     }
 };
 
 template <typename T, typename A>
-constexpr dynamic_buffer<T, A>::dynamic_buffer(uninitialized_t, size_type size) :
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, uninitialized_t, size_type size) :
     size{ size },
-    allocator{},
-    data{ traits::allocate(allocator, size) }
+    capacity{ size },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
 {};
 
+/*
+    Adopts data, which must have been allocated by an allocator equal to allocator.
+*/
 template <typename T, typename A>
-constexpr dynamic_buffer<T, A>::dynamic_buffer(pointer data, size_type size) :
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, pointer data, size_type size) :
     size{ size },
-    allocator{},
+    capacity{ size },
+    allocator{ allocator },
     data{ data }
 {
-    contract;
-        post(data ? size > 0 : size == 0);
+    default_checking::check(data ? size > 0 : size == 0);
+};
+
+/*
+    Constructs element i from generator(i), for each i in [0, count) in order.
+*/
+template <typename T, typename A>
+template <typename F>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, from_generator_t, size_type count, F&& generator) :
+    capacity{ count },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
+{
+    try
+    {
+        for (; size < count; ++size)
+        {
+            traits::construct(this->allocator, data + size, std::invoke(generator, size));
+        }
+    }
+    catch (...)
+    {
+        release_storage();
+        throw;
+    }
+};
+
+/*
+    Calls writer once with a construct_iterator, the buffer holds whatever was written through it.
+    That must fit in the capacity, count or more if the allocator hands out larger blocks,
+    writing more throws std::length_error.
+*/
+template <typename T, typename A>
+template <typename F>
+constexpr dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, from_output_t, size_type count, F&& writer) :
+    capacity{ count },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
+{
+    try
+    {
+        std::invoke(std::forward<F>(writer), construct_iterator{ this });
+    }
+    catch (...)
+    {
+        release_storage();
+        throw;
+    }
+};
+
+template <typename T, typename A>
+template <typename... Args>
+dynamic_buffer<T, A>::dynamic_buffer(parallel_t policy, size_type size, Args&&... arguments) :
+    dynamic_buffer{ std::allocator_arg, allocator_type{}, policy, size, std::forward<Args>(arguments)... }
+{};
+
+template <typename T, typename A>
+dynamic_buffer<T, A>::dynamic_buffer(parallel_t policy, const dynamic_buffer& other) :
+    dynamic_buffer{ std::allocator_arg, traits::select_on_container_copy_construction(other.allocator), policy, other }
+{};
+
+/*
+    Every thread constructs its slice from the same arguments, so they are never moved from.
+*/
+template <typename T, typename A>
+template <typename... Args>
+dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, parallel_t policy, size_type size, Args&&... arguments) :
+    size{ size },
+    capacity{ size },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
+{
+    try
+    {
+        parallel_slices(policy, size, parallel_grain,
+            [&](size_type first, size_type last) { construct_elements(this->allocator, data + first, last - first, arguments...); },
+            [&](size_type first, size_type last) { destroy_elements(this->allocator, data + first, last - first); });
+    }
+    catch (...)
+    {
+        deallocate_storage(this->allocator, data, capacity);
+        throw;
+    }
+};
+
+template <typename T, typename A>
+dynamic_buffer<T, A>::dynamic_buffer(std::allocator_arg_t, const allocator_type& allocator, parallel_t policy, const dynamic_buffer& other) :
+    size{ other.size },
+    capacity{ other.size },
+    allocator{ allocator },
+    data{ allocate_storage(this->allocator, capacity) }
+{
+    try
+    {
+        parallel_slices(policy, size, parallel_grain,
+            [&](size_type first, size_type last) { copy_elements(this->allocator, data + first, std::to_address(other.data) + first, last - first); },
+            [&](size_type first, size_type last) { destroy_elements(this->allocator, data + first, last - first); });
+    }
+    catch (...)
+    {
+        deallocate_storage(this->allocator, data, capacity);
+        throw;
+    }
 };
 
 template <typename T, typename A>
 constexpr auto dynamic_buffer<T, A>::operator [](size_type index) & -> value_type&
 {
-    contract;
-        pre(index < size);
+    check_index(index, size);
 
     return data[index];
 };
@@ -315,8 +937,7 @@ constexpr auto dynamic_buffer<T, A>::operator [](size_type index) & -> value_typ
 template <typename T, typename A>
 constexpr auto dynamic_buffer<T, A>::operator [](size_type index) const& -> const value_type&
 {
-    contract;
-        pre(index < size);
+    check_index(index, size);
 
     return data[index];
 };
@@ -324,8 +945,7 @@ constexpr auto dynamic_buffer<T, A>::operator [](size_type index) const& -> cons
 template <typename T, typename A>
 constexpr auto dynamic_buffer<T, A>::operator [](size_type index) && -> value_type&&
 {
-    contract;
-        pre(index < size);
+    check_index(index, size);
 
     return std::move(data[index]);
 };
@@ -338,81 +958,348 @@ constexpr auto operator ==(const dynamic_buffer<T, A>& left, const dynamic_buffe
         return false;
     }
 
-    for (std::size_t i = 0; i < left.size; ++i)
+    return equal_elements(std::to_address(left.data), std::to_address(right.data), left.size);
+};
+
+template <typename T, typename A>
+constexpr auto operator <=>(const dynamic_buffer<T, A>& left, const dynamic_buffer<T, A>& right) noexcept -> std::partial_ordering
+{
+    return compare_elements(std::to_address(left.data), left.size, std::to_address(right.data), right.size);
+};
+
+/*
+    Provides the strong exception guarantee unless value_type is move-only with a throwing move.
+    Sizes within the capacity are handled in place, shrinking never releases memory.
+    Arguments may refer into the buffer.
+*/
+template <typename T, typename A>
+template <typename... Args>
+constexpr auto dynamic_buffer<T, A>::resize(size_type new_size, Args&&... arguments) -> void
+{
+    if (size == new_size)
+    {
+        return;
+    }
+
+    if (new_size == 0)
+    {
+        release_storage();
+        return;
+    }
+
+    if (new_size < size)
+    {
+        destroy_elements(allocator, data + new_size, size - new_size);
+        size = new_size;
+        return;
+    }
+
+    if (new_size <= capacity or expand_storage(new_size))
+    {
+        construct_elements(allocator, data + size, new_size - size, std::forward<Args>(arguments)...);
+        size = new_size;
+        return;
+    }
+
+    if constexpr (sizeof...(Args) == 0)
+    {
+        reallocate_storage(new_size);
+        construct_elements(allocator, data + size, new_size - size);
+        size = new_size;
+    }
+    else if constexpr (is_bulk_copyable and std::is_constructible_v<value_type, Args&&...>)
+    {
+        // reallocating first would leave any argument that refers into the buffer dangling.
+        const value_type value(std::forward<Args>(arguments)...);
+        reallocate_storage(new_size);
+        construct_elements(allocator, data + size, new_size - size, value);
+        size = new_size;
+    }
+    else
     {
-        if (left[i] != right[i])
+        // build the new elements before relocating the old ones, for the same reason.
+        size_type new_capacity = new_size;
+        pointer new_data = allocate_storage(allocator, new_capacity);
+        try
         {
-            return false;
+            construct_elements(allocator, new_data + size, new_size - size, std::forward<Args>(arguments)...);
+        }
+        catch (...)
+        {
+            deallocate_storage(allocator, new_data, new_capacity);
+            throw;
+        }
+        try
+        {
+            relocate_elements(allocator, new_data, data, size);
+        }
+        catch (...)
+        {
+            destroy_elements(allocator, new_data + size, new_size - size);
+            deallocate_storage(allocator, new_data, new_capacity);
+            throw;
         }
-    }
 
-    return true;
+        record_reallocation(allocator);
+        deallocate_storage(allocator, data, capacity);
+        size = new_size;
+        capacity = new_capacity;
+        data = new_data;
+    }
 };
 
 template <typename T, typename A>
-constexpr auto operator <=>(const dynamic_buffer<T, A>& left, const dynamic_buffer<T, A>& right) noexcept -> std::partial_ordering
+constexpr auto dynamic_buffer<T, A>::resize(uninitialized_t, size_type new_size) -> void
 {
-    if (not left.data or not right.data)
+    if (size == new_size)
     {
-        return std::partial_ordering::unordered;
+        return;
     }
 
-    if (left.size != right.size)
+    if (new_size == 0)
     {
-        return left.size <=> right.size;
+        release_storage();
+        return;
     }
 
-    for (std::size_t i = 0; i < left.size; ++i)
+    if (new_size < size)
     {
-        auto value = left[i] <=> right[i];
-        if (value != 0)
-        {
-            return value;
-        }
+        destroy_elements(allocator, data + new_size, size - new_size);
+    }
+    else if (new_size > capacity and not expand_storage(new_size))
+    {
+        reallocate_storage(new_size);
+    }
+    size = new_size;
+};
+
+/*
+    Makes room for count elements and lets op write them in place, as std::string's does.
+    op(data, count) sees the current elements at the front of the storage, may write any of the first
+    count slots, and returns how many of them the buffer holds afterwards, at most count.
+    Nothing is written besides what op writes, so it is only for trivially copyable elements.
+    If op throws, or returns more than count, which throws std::length_error, the buffer keeps its old size,
+    with whatever op wrote.
+*/
+template <typename T, typename A>
+template <typename Op>
+constexpr auto dynamic_buffer<T, A>::resize_and_overwrite(size_type count, Op op) -> void
+{
+    static_assert(is_bulk_copyable, "elements must be trivially copyable and built without the allocator");
+
+    if (count > capacity and not expand_storage(count))
+    {
+        reallocate_storage(count);
     }
 
-    return std::partial_ordering::equivalent;
+    const size_type written = std::move(op)(std::to_address(data), count);
+    if (written > count)
+    {
+        throw std::length_error{ "resize_and_overwrite was told more elements were written than it allowed" };
+    }
+    size = written;
 };
 
+/*
+    Same guarantees as resize, the new elements are built by several threads.
+    When growing past the capacity, trivially relocatable elements are also moved by several threads,
+    so each thread first touches one contiguous slice of the new storage.
+*/
 template <typename T, typename A>
 template <typename... Args>
-constexpr auto dynamic_buffer<T, A>::resize(size_type new_size, Args&&... arguments) -> void
+auto dynamic_buffer<T, A>::resize(parallel_t policy, size_type new_size, Args&&... arguments) -> void
 {
     if (size == new_size)
     {
         return;
     }
 
-    const size_type limit = std::min(size, new_size);
-    dynamic_buffer new_buffer(uninitialized, new_size);
-    for (size_type i = 0; i < limit; ++i)
+    if (new_size == 0)
+    {
+        release_storage();
+        return;
+    }
+
+    if (new_size < size)
+    {
+        destroy_elements(allocator, data + new_size, size - new_size);
+        size = new_size;
+        return;
+    }
+
+    if (new_size <= capacity or expand_storage(new_size))
     {
-        traits::construct(new_buffer.allocator, new_buffer.data + i, *(data + i));
+        parallel_slices(policy, new_size - size, parallel_grain,
+            [&](size_type first, size_type last) { construct_elements(allocator, data + size + first, last - first, arguments...); },
+            [&](size_type first, size_type last) { destroy_elements(allocator, data + size + first, last - first); });
+        size = new_size;
+        return;
+    }
+
+    // the old elements stay put until every new one is built, so arguments may refer into the buffer.
+    size_type new_capacity = new_size;
+    pointer new_data = allocate_storage(allocator, new_capacity);
+    const size_type old_size = size;
+    const size_type moved = is_bulk_relocatable ? old_size : 0;
+    try
+    {
+        parallel_slices(policy, new_size - old_size + moved, parallel_grain,
+            [&](size_type first, size_type last)
+            {
+                first += old_size - moved;
+                last += old_size - moved;
+                if constexpr (is_bulk_relocatable)
+                {
+                    if (first < old_size)
+                    {
+                        std::memcpy(static_cast<void*>(std::to_address(new_data + first)), static_cast<const void*>(std::to_address(data + first)), (std::min(last, old_size) - first) * sizeof(value_type));
+                        first = std::min(last, old_size);
+                    }
+                }
+                construct_elements(allocator, new_data + first, last - first, arguments...);
+            },
+            [&](size_type first, size_type last)
+            {
+                first = std::max(first + old_size - moved, old_size);
+                last += old_size - moved;
+                if (first < last)
+                {
+                    destroy_elements(allocator, new_data + first, last - first);
+                }
+            });
     }
-    for (size_type i = limit; i < new_size; ++i)
+    catch (...)
     {
-        traits::construct(new_buffer.allocator, new_buffer.data + i, std::forward<Args>(arguments)...);
+        deallocate_storage(allocator, new_data, new_capacity);
+        throw;
+    }
+    record_moves(allocator, moved);
+    if constexpr (not is_bulk_relocatable)
+    {
+        try
+        {
+            relocate_elements(allocator, new_data, data, old_size);
+        }
+        catch (...)
+        {
+            destroy_elements(allocator, new_data + old_size, new_size - old_size);
+            deallocate_storage(allocator, new_data, new_capacity);
+            throw;
+        }
     }
 
-    swap(*this, new_buffer);
+    record_reallocation(allocator);
+    deallocate_storage(allocator, data, capacity);
+    size = new_size;
+    capacity = new_capacity;
+    data = new_data;
 };
 
 template <typename T, typename A>
-constexpr auto dynamic_buffer<T, A>::resize(uninitialized_t, size_type new_size) -> void
+constexpr auto dynamic_buffer<T, A>::shrink_to_fit() -> void
 {
-    if (size == new_size)
+    if (size == capacity)
     {
         return;
     }
 
-    const size_type limit = std::min(size, new_size);
-    dynamic_buffer new_buffer(uninitialized, new_size);
-    for (size_type i = 0; i < limit; ++i)
+    if (size == 0)
     {
-        traits::construct(new_buffer.allocator, new_buffer.data + i, *(data + i));
+        release_storage();
+        return;
     }
 
-    swap(*this, new_buffer);
+    if (not expand_storage(size))
+    {
+        reallocate_storage(size);
+    }
+};
+
+/*
+    Asks the allocator to grow or shrink the block at its current address.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::expand_storage(size_type count) -> bool
+{
+    if constexpr (requires { { allocator.expand(data, capacity, count) } -> std::convertible_to<size_type>; })
+    {
+        if (data)
+        {
+            if (const size_type expanded = allocator.expand(data, capacity, count); expanded >= count)
+            {
+                capacity = expanded;
+                return true;
+            }
+        }
+    }
+
+    return false;
+};
+
+/*
+    Moves the elements into a block holding at least count elements, count must not be less than size.
+    Leaves the buffer untouched if this throws.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::reallocate_storage(size_type count) -> void
+{
+    if constexpr (is_bulk_relocatable and requires { allocator.reallocate(data, capacity, count); })
+    {
+        if (data)
+        {
+            auto [new_data, new_capacity] = allocator.reallocate(data, capacity, count);
+            record_moves(allocator, size);
+            record_reallocation(allocator);
+            data = new_data;
+            capacity = new_capacity;
+            return;
+        }
+    }
+
+    size_type new_capacity = count;
+    pointer new_data = allocate_storage(allocator, new_capacity);
+    try
+    {
+        relocate_elements(allocator, new_data, data, size);
+    }
+    catch (...)
+    {
+        deallocate_storage(allocator, new_data, new_capacity);
+        throw;
+    }
+
+    record_reallocation(allocator);
+    deallocate_storage(allocator, data, capacity);
+    capacity = new_capacity;
+    data = new_data;
+};
+
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::release_storage() -> void
+{
+    destroy_elements(allocator, data, size);
+    deallocate_storage(allocator, data, capacity);
+    size = 0;
+    capacity = 0;
+    data = nullptr;
+};
+
+/*
+    Takes over the storage of other, leaving it empty.
+    This buffer must hold no storage and its allocator must be able to deallocate what other's allocated.
+*/
+template <typename T, typename A>
+constexpr auto dynamic_buffer<T, A>::take_storage(dynamic_buffer& other) noexcept -> void
+{
+    size = std::exchange(other.size, 0);
+    capacity = std::exchange(other.capacity, 0);
+    data = std::exchange(other.data, nullptr);
+};
+
+namespace pmr
+{
+    template <typename T>
+    using dynamic_buffer = ::dynamic_buffer<T, std::pmr::polymorphic_allocator<T>>;
 };
 
 template <typename T, typename A = std::allocator<T>>
@@ -591,6 +1478,20 @@ constexpr auto dynamic_buffer<T, A>::const_iterator::operator ->() const -> poin
     return data;
 };
 
+template <typename T, typename A>
+template <typename... Args>
+constexpr auto dynamic_buffer<T, A>::construct_iterator::emplace(Args&&... arguments) -> void
+{
+    // not an index the caller chose, so this is checked whatever the checking policy says.
+    if (buffer->size == buffer->capacity)
+    {
+        throw std::length_error{ "from_output writer wrote past the buffer's capacity" };
+    }
+
+    traits::construct(buffer->allocator, buffer->data + buffer->size, std::forward<Args>(arguments)...);
+    ++buffer->size;
+};
+
 template <typename T, typename A = std::allocator<T>>
 using dynamic_buffer_reverse_iterator = typename dynamic_buffer<T, A>::reverse_iterator;
 
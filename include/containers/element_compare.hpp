@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/*
+    Comparison kernels shared by the buffers.
+    Element types whose equality is the equality of their bytes are compared with memcmp,
+    which the C library already vectorizes and dispatches on the running CPU.
+*/
+
+template <typename T>
+constexpr bool is_bitwise_comparable_v = std::is_integral_v<T> or std::is_enum_v<T> or std::is_pointer_v<T>;
+
+/*
+    Byte sized unsigned types, for which memcmp also gives the lexicographic order.
+*/
+template <typename T>
+constexpr bool is_bytewise_ordered_v = sizeof(T) == 1 and (std::is_integral_v<T> or std::is_enum_v<T>) and
+    std::is_unsigned_v<typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>, std::type_identity<T>>::type>;
+
+/*
+    Returns the index of the first element that differs, or count if there is none.
+*/
+template <typename T>
+constexpr auto mismatch_elements(const T* left, const T* right, std::size_t count) -> std::size_t
+{
+    std::size_t i = 0;
+    if constexpr (is_bitwise_comparable_v<T>)
+    {
+        if !consteval
+        {
+            constexpr std::size_t block = std::max<std::size_t>(512 / sizeof(T), 1);
+            for (; i + block <= count; i += block)
+            {
+                if (std::memcmp(left + i, right + i, block * sizeof(T)) != 0)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    for (; i < count; ++i)
+    {
+        if (not (left[i] == right[i]))
+        {
+            return i;
+        }
+    }
+
+    return count;
+};
+
+template <typename T>
+constexpr auto equal_elements(const T* left, const T* right, std::size_t count) -> bool
+{
+    if constexpr (is_bitwise_comparable_v<T>)
+    {
+        if !consteval
+        {
+            return count == 0 or std::memcmp(left, right, count * sizeof(T)) == 0;
+        }
+    }
+
+    return mismatch_elements(left, right, count) == count;
+};
+
+/*
+    Lexicographic three way comparison, a shorter prefix orders before the longer sequence.
+*/
+template <typename T>
+constexpr auto compare_elements(const T* left, std::size_t left_size, const T* right, std::size_t right_size) -> std::compare_three_way_result_t<T>
+{
+    const std::size_t limit = std::min(left_size, right_size);
+    if constexpr (is_bytewise_ordered_v<T>)
+    {
+        if !consteval
+        {
+            if (limit > 0)
+            {
+                if (const int value = std::memcmp(left, right, limit); value != 0)
+                {
+                    return value <=> 0;
+                }
+            }
+            return left_size <=> right_size;
+        }
+    }
+
+    if (const std::size_t index = mismatch_elements(left, right, limit); index < limit)
+    {
+        return left[index] <=> right[index];
+    }
+
+    return left_size <=> right_size;
+};
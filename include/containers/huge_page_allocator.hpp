@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+#include "aligned_allocator.hpp"
+
+#ifndef CONTAINERS_HAS_MMAN
+#if __has_include(<sys/mman.h>)
+#define CONTAINERS_HAS_MMAN 1
+#else
+#define CONTAINERS_HAS_MMAN 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_MMAN
+#include <sys/mman.h>
+#endif
+
+/*
+    An allocator that maps blocks of at least Threshold bytes straight from the kernel, aligned to
+    and rounded up to a whole huge page, and asks for them to be backed by transparent huge pages.
+    Smaller blocks come from aligned_allocator.
+    Mapped blocks can grow through mremap, which lets dynamic_buffer resize trivially relocatable
+    elements without copying them. A block that cannot grow in place has its pages moved onto a new
+    huge page aligned block.
+    Without <sys/mman.h> every block comes from aligned_allocator.
+*/
+
+template <typename T, std::size_t Threshold = std::size_t{ 1 } << 21, std::size_t Alignment = 64>
+struct huge_page_allocator
+{
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+    using small_allocator = aligned_allocator<T, Alignment>;
+
+    static constexpr std::size_t threshold = Threshold;
+    static constexpr std::size_t huge_page_size = std::size_t{ 1 } << 21;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = huge_page_allocator<U, Threshold, Alignment>;
+    };
+
+    struct allocation_result
+    {
+        T* ptr = nullptr;
+        size_type count = 0;
+    };
+
+    constexpr huge_page_allocator() noexcept = default;
+    template <typename U>
+    constexpr huge_page_allocator(const huge_page_allocator<U, Threshold, Alignment>&) noexcept {};
+
+    auto allocate(size_type count) -> T*;
+    auto allocate_at_least(size_type count) -> allocation_result;
+    auto deallocate(T* data, size_type count) noexcept -> void;
+#if CONTAINERS_HAS_MMAN && defined(MREMAP_MAYMOVE)
+    auto reallocate(T* data, size_type capacity, size_type count) -> allocation_result;
+#endif
+
+    static constexpr auto is_mapped(size_type count) noexcept -> bool
+    {
+        return CONTAINERS_HAS_MMAN and count * sizeof(T) >= Threshold;
+    };
+    static constexpr auto mapped_bytes(size_type count) noexcept -> std::size_t
+    {
+        return (count * sizeof(T) + huge_page_size - 1) & ~(huge_page_size - 1);
+    };
+
+    static auto map(std::size_t bytes) -> void*;
+    static auto unmap(void* data, std::size_t bytes) noexcept -> void;
+
+    template <typename U>
+    constexpr auto operator ==(const huge_page_allocator<U, Threshold, Alignment>&) const noexcept -> bool
+    {
+        return true;
+    };
+};
+
+template <typename T, std::size_t Threshold = std::size_t{ 1 } << 21, std::size_t Alignment = 64>
+using huge_page_buffer = dynamic_buffer<T, huge_page_allocator<T, Threshold, Alignment>>;
+
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::allocate(size_type count) -> T*
+{
+    return allocate_at_least(count).ptr;
+};
+
+/*
+    Mapped blocks report everything up to the end of their last huge page as usable.
+*/
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::allocate_at_least(size_type count) -> allocation_result
+{
+    if (count > (std::numeric_limits<size_type>::max() - huge_page_size) / sizeof(T))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    if (not is_mapped(count))
+    {
+        return { small_allocator{}.allocate(count), count };
+    }
+
+    const std::size_t bytes = mapped_bytes(count);
+    return { static_cast<T*>(map(bytes)), bytes / sizeof(T) };
+};
+
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::deallocate(T* data, size_type count) noexcept -> void
+{
+    if (not is_mapped(count))
+    {
+        small_allocator{}.deallocate(data, count);
+        return;
+    }
+
+    unmap(data, mapped_bytes(count));
+};
+
+#if CONTAINERS_HAS_MMAN && defined(MREMAP_MAYMOVE)
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::reallocate(T* data, size_type capacity, size_type count) -> allocation_result
+{
+    if (not is_mapped(capacity) or not is_mapped(count))
+    {
+        // crossing the threshold changes where the block comes from, so copy.
+        allocation_result result = allocate_at_least(count);
+        std::memcpy(static_cast<void*>(result.ptr), static_cast<const void*>(data), std::min(capacity, count) * sizeof(T));
+        deallocate(data, capacity);
+        return result;
+    }
+
+    // resizing in place keeps the start, and with it the huge page alignment.
+    const std::size_t old_bytes = mapped_bytes(capacity);
+    const std::size_t bytes = mapped_bytes(count);
+    void* new_data = ::mremap(data, old_bytes, bytes, 0);
+    if (new_data == MAP_FAILED)
+    {
+        // mremap would move the block to any page boundary, so move its pages onto an aligned block instead.
+        void* target = map(bytes);
+#if defined(MREMAP_FIXED)
+        new_data = ::mremap(data, old_bytes, bytes, MREMAP_MAYMOVE | MREMAP_FIXED, target);
+        if (new_data == MAP_FAILED)
+        {
+            unmap(target, bytes);
+            throw std::bad_alloc{};
+        }
+#else
+        std::memcpy(target, static_cast<const void*>(data), std::min(old_bytes, bytes));
+        unmap(data, old_bytes);
+        new_data = target;
+#endif
+    }
+#if defined(MADV_HUGEPAGE)
+    ::madvise(new_data, bytes, MADV_HUGEPAGE);
+#endif
+
+    return { static_cast<T*>(new_data), bytes / sizeof(T) };
+};
+#endif
+
+/*
+    Over maps by a huge page so the block can be trimmed to start on a huge page boundary.
+*/
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::map([[maybe_unused]] std::size_t bytes) -> void*
+{
+#if CONTAINERS_HAS_MMAN
+    const std::size_t mapped = bytes + huge_page_size;
+    void* region = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+        throw std::bad_alloc{};
+    }
+
+    const auto start = reinterpret_cast<std::uintptr_t>(region);
+    const auto aligned = (start + huge_page_size - 1) & ~(huge_page_size - 1);
+    if (aligned > start)
+    {
+        ::munmap(region, aligned - start);
+    }
+    if (const std::size_t tail = start + mapped - (aligned + bytes); tail > 0)
+    {
+        ::munmap(reinterpret_cast<void*>(aligned + bytes), tail);
+    }
+
+#if defined(MADV_HUGEPAGE)
+    ::madvise(reinterpret_cast<void*>(aligned), bytes, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+#else
+    throw std::bad_alloc{};
+#endif
+};
+
+template <typename T, std::size_t Threshold, std::size_t Alignment>
+auto huge_page_allocator<T, Threshold, Alignment>::unmap([[maybe_unused]] void* data, [[maybe_unused]] std::size_t bytes) noexcept -> void
+{
+#if CONTAINERS_HAS_MMAN
+    ::munmap(data, bytes);
+#endif
+};
@@ -0,0 +1,600 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include <fmt/format.h>
+#include <spdlog/spdlog.h>
+
+#include "dynamic_buffer.hpp"
+
+/*
+    Counts what buffers of each element type do with their memory, to find the buffers behind
+    memory churn without a heap profiler.
+
+    instrumented_allocator<T, Upstream> forwards to Upstream, std::allocator by default, and records
+    per element type the allocations and deallocations, bytes allocated, live and peak live bytes,
+    a histogram of allocation sizes in powers of two, and through dynamic_buffer's hooks the elements
+    copied and moved into the buffer and how many times its storage moved to a new block.
+    allocate_at_least, expand and reallocate are provided whenever Upstream provides them.
+
+    Every thread counts into its own block per type, only ever written by that thread, so recording
+    is a few plain loads and stores. allocation_report() sums the blocks of every thread,
+    and a thread's counts are folded into the totals when it exits.
+    Live bytes are exact, peak live bytes are the sum of each thread's peak, which is an upper bound,
+    and exact when a type is only allocated and freed on one thread.
+
+    log_allocation_report writes a report to a spdlog logger, allocation_report_json formats it as JSON,
+    and allocation_reporter hands a report to either of them, or anything else, on a fixed interval.
+*/
+
+struct allocation_summary
+{
+    static constexpr std::size_t bucket_count = 64;
+
+    std::string type;
+    std::size_t element_size = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t reallocations = 0;
+    std::uint64_t bytes_allocated = 0;
+    std::int64_t live_bytes = 0;
+    std::int64_t peak_live_bytes = 0;
+    std::uint64_t copies = 0;
+    std::uint64_t moves = 0;
+    // sizes[i] counts the allocations of more than bucket_limit(i) / 2 bytes, up to bucket_limit(i).
+    std::array<std::uint64_t, bucket_count> sizes = {};
+
+    static constexpr auto bucket_of(std::size_t bytes) noexcept -> std::size_t
+    {
+        return std::min<std::size_t>(std::bit_width(std::max<std::size_t>(bytes, 1) - 1), bucket_count - 1);
+    };
+    static constexpr auto bucket_limit(std::size_t index) noexcept -> std::size_t
+    {
+        return std::size_t{ 1 } << index;
+    };
+};
+
+struct allocation_stats
+{
+    /*
+        One thread's counts for one type. Other threads only read them, for a report.
+    */
+    struct counters
+    {
+        std::atomic<std::uint64_t> allocations = 0;
+        std::atomic<std::uint64_t> deallocations = 0;
+        std::atomic<std::uint64_t> reallocations = 0;
+        std::atomic<std::uint64_t> bytes_allocated = 0;
+        std::atomic<std::int64_t> live_bytes = 0;
+        std::atomic<std::int64_t> peak_live_bytes = 0;
+        std::atomic<std::uint64_t> copies = 0;
+        std::atomic<std::uint64_t> moves = 0;
+        std::array<std::atomic<std::uint64_t>, allocation_summary::bucket_count> sizes = {};
+
+        auto allocated(std::size_t bytes) noexcept -> void;
+        auto deallocated(std::size_t bytes) noexcept -> void;
+        auto resized(std::size_t old_bytes, std::size_t new_bytes) noexcept -> void;
+        auto add_to(allocation_summary& summary) const noexcept -> void;
+        auto merge(const counters& other) noexcept -> void;
+    };
+    struct type_entry
+    {
+        std::string name;
+        std::size_t element_size = 0;
+        std::vector<counters*> threads;
+        counters retired;
+    };
+    template <typename T>
+    struct local_counters
+    {
+        counters* values;
+
+        local_counters();
+        ~local_counters();
+    };
+
+    template <typename T>
+    static inline thread_local constinit bool finished = false;
+
+    // the single writer needs no read-modify-write, which would be a locked instruction.
+    template <typename U>
+    static auto bump(std::atomic<U>& counter, U amount) noexcept -> void
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    };
+
+    static auto mutex() noexcept -> std::mutex&;
+    static auto types() noexcept -> std::vector<type_entry*>&;
+    static auto type_name(const std::type_info& type) -> std::string;
+    template <typename T>
+    static auto entry() -> type_entry&;
+    template <typename T>
+    static auto enroll() -> counters*;
+    template <typename T, typename F>
+    static auto record(F&& update) noexcept -> void;
+    static auto report() -> std::vector<allocation_summary>;
+};
+
+template <typename T, typename Upstream = std::allocator<T>>
+struct instrumented_allocator
+{
+    using upstream_type = Upstream;
+    using upstream_traits = std::allocator_traits<Upstream>;
+
+    static_assert(std::is_same_v<typename upstream_traits::value_type, T>, "the upstream allocator must allocate T");
+    static_assert(std::is_same_v<typename upstream_traits::pointer, T*>, "the upstream allocator must hand out plain pointers");
+
+    using value_type = T;
+    using size_type = typename upstream_traits::size_type;
+    using difference_type = typename upstream_traits::difference_type;
+    using propagate_on_container_copy_assignment = typename upstream_traits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment = typename upstream_traits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap = typename upstream_traits::propagate_on_container_swap;
+    using is_always_equal = typename upstream_traits::is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = instrumented_allocator<U, typename upstream_traits::template rebind_alloc<U>>;
+    };
+
+    struct allocation_result
+    {
+        T* ptr = nullptr;
+        size_type count = 0;
+    };
+
+    [[no_unique_address]] Upstream upstream = {};
+
+    constexpr instrumented_allocator() noexcept = default;
+    constexpr explicit instrumented_allocator(const Upstream& upstream) noexcept :
+        upstream{ upstream }
+    {};
+    template <typename U, typename B>
+    constexpr instrumented_allocator(const instrumented_allocator<U, B>& other) noexcept :
+        upstream{ other.upstream }
+    {};
+
+    auto allocate(size_type count) -> T*;
+    auto allocate_at_least(size_type count) -> allocation_result
+        requires requires (Upstream& upstream, size_type count) { upstream.allocate_at_least(count); };
+    auto deallocate(T* data, size_type count) noexcept -> void;
+    auto expand(T* data, size_type capacity, size_type count) -> size_type
+        requires requires (Upstream& upstream, T* data, size_type count) { upstream.expand(data, count, count); };
+    auto reallocate(T* data, size_type capacity, size_type count) -> allocation_result
+        requires requires (Upstream& upstream, T* data, size_type count) { upstream.reallocate(data, count, count); };
+
+    auto record_copies(size_type count) noexcept -> void;
+    auto record_moves(size_type count) noexcept -> void;
+    auto record_reallocation() noexcept -> void;
+
+    auto select_on_container_copy_construction() const -> instrumented_allocator
+    {
+        return instrumented_allocator{ upstream_traits::select_on_container_copy_construction(upstream) };
+    };
+
+    template <typename U, typename B>
+    constexpr auto operator ==(const instrumented_allocator<U, B>& other) const noexcept -> bool
+    {
+        return upstream == other.upstream;
+    };
+};
+
+template <typename T, typename Upstream = std::allocator<T>>
+using instrumented_buffer = dynamic_buffer<T, instrumented_allocator<T, Upstream>>;
+
+inline auto allocation_stats::counters::allocated(std::size_t bytes) noexcept -> void
+{
+    bump<std::uint64_t>(allocations, 1);
+    bump<std::uint64_t>(bytes_allocated, bytes);
+    bump<std::uint64_t>(sizes[allocation_summary::bucket_of(bytes)], 1);
+    resized(0, bytes);
+};
+
+inline auto allocation_stats::counters::deallocated(std::size_t bytes) noexcept -> void
+{
+    bump<std::uint64_t>(deallocations, 1);
+    resized(bytes, 0);
+};
+
+/*
+    A block changed size where it was, only the live bytes move.
+*/
+inline auto allocation_stats::counters::resized(std::size_t old_bytes, std::size_t new_bytes) noexcept -> void
+{
+    const std::int64_t live = live_bytes.load(std::memory_order_relaxed) + static_cast<std::int64_t>(new_bytes) - static_cast<std::int64_t>(old_bytes);
+    live_bytes.store(live, std::memory_order_relaxed);
+    if (live > peak_live_bytes.load(std::memory_order_relaxed))
+    {
+        peak_live_bytes.store(live, std::memory_order_relaxed);
+    }
+};
+
+inline auto allocation_stats::counters::add_to(allocation_summary& summary) const noexcept -> void
+{
+    summary.allocations += allocations.load(std::memory_order_relaxed);
+    summary.deallocations += deallocations.load(std::memory_order_relaxed);
+    summary.reallocations += reallocations.load(std::memory_order_relaxed);
+    summary.bytes_allocated += bytes_allocated.load(std::memory_order_relaxed);
+    summary.live_bytes += live_bytes.load(std::memory_order_relaxed);
+    summary.peak_live_bytes += peak_live_bytes.load(std::memory_order_relaxed);
+    summary.copies += copies.load(std::memory_order_relaxed);
+    summary.moves += moves.load(std::memory_order_relaxed);
+    for (std::size_t i = 0; i < allocation_summary::bucket_count; ++i)
+    {
+        summary.sizes[i] += sizes[i].load(std::memory_order_relaxed);
+    }
+};
+
+/*
+    Only called with the registry locked, which is also the only way to write a type's retired counts.
+*/
+inline auto allocation_stats::counters::merge(const counters& other) noexcept -> void
+{
+    bump(allocations, other.allocations.load(std::memory_order_relaxed));
+    bump(deallocations, other.deallocations.load(std::memory_order_relaxed));
+    bump(reallocations, other.reallocations.load(std::memory_order_relaxed));
+    bump(bytes_allocated, other.bytes_allocated.load(std::memory_order_relaxed));
+    bump(live_bytes, other.live_bytes.load(std::memory_order_relaxed));
+    bump(peak_live_bytes, other.peak_live_bytes.load(std::memory_order_relaxed));
+    bump(copies, other.copies.load(std::memory_order_relaxed));
+    bump(moves, other.moves.load(std::memory_order_relaxed));
+    for (std::size_t i = 0; i < allocation_summary::bucket_count; ++i)
+    {
+        bump(sizes[i], other.sizes[i].load(std::memory_order_relaxed));
+    }
+};
+
+template <typename T>
+allocation_stats::local_counters<T>::local_counters()
+{
+    // owned here until the registry holds it, so a throwing entry or push_back does not leak it.
+    auto owned = std::make_unique<counters>();
+    type_entry& type = entry<T>();
+    std::lock_guard lock{ mutex() };
+    type.threads.push_back(owned.get());
+    values = owned.release();
+};
+
+template <typename T>
+allocation_stats::local_counters<T>::~local_counters()
+{
+    finished<T> = true;
+    type_entry& type = entry<T>();
+    {
+        std::lock_guard lock{ mutex() };
+        std::erase(type.threads, values);
+        type.retired.merge(*values);
+    }
+    delete values;
+};
+
+/*
+    Never destroyed, buffers may still be freed while other statics are torn down.
+*/
+inline auto allocation_stats::mutex() noexcept -> std::mutex&
+{
+    static std::mutex* registry_mutex = new std::mutex{};
+    return *registry_mutex;
+};
+
+inline auto allocation_stats::types() noexcept -> std::vector<type_entry*>&
+{
+    static std::vector<type_entry*>* registry_types = new std::vector<type_entry*>{};
+    return *registry_types;
+};
+
+inline auto allocation_stats::type_name(const std::type_info& type) -> std::string
+{
+#if defined(__GNUG__)
+    int status = 0;
+    if (char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status))
+    {
+        std::string name{ demangled };
+        std::free(demangled);
+        return name;
+    }
+#endif
+    return type.name();
+};
+
+template <typename T>
+auto allocation_stats::entry() -> type_entry&
+{
+    static type_entry* const type = []
+    {
+        type_entry* created = new type_entry{ type_name(typeid(T)), sizeof(T), {}, {} };
+        std::lock_guard lock{ mutex() };
+        types().push_back(created);
+        return created;
+    }();
+    return *type;
+};
+
+/*
+    This thread's counts for T, registering them on first use, which allocates and may throw.
+    Returns nullptr once the thread's counts have been folded into the totals.
+*/
+template <typename T>
+auto allocation_stats::enroll() -> counters*
+{
+    if (finished<T>)
+    {
+        return nullptr;
+    }
+
+    thread_local local_counters<T> local;
+    return local.values;
+};
+
+/*
+    Applies update to this thread's counts for T.
+    The allocating calls enroll the thread first, so registering here only happens for a thread that
+    frees or moves elements of a type it never allocated. If that registration runs out of memory,
+    and once the thread's counts have been folded into the totals, updates go to the totals directly.
+*/
+template <typename T, typename F>
+auto allocation_stats::record(F&& update) noexcept -> void
+{
+    counters* values = nullptr;
+    try
+    {
+        values = enroll<T>();
+    }
+    catch (...)
+    {
+        // out of memory registering this thread, counted into the totals below instead.
+    }
+    if (values)
+    {
+        update(*values);
+        return;
+    }
+
+    type_entry* type = nullptr;
+    try
+    {
+        type = &entry<T>();
+    }
+    catch (...)
+    {
+        // nothing of T was ever counted and there is no memory to start, so this update is lost.
+        return;
+    }
+    std::lock_guard lock{ mutex() };
+    update(type->retired);
+};
+
+inline auto allocation_stats::report() -> std::vector<allocation_summary>
+{
+    std::lock_guard lock{ mutex() };
+    std::vector<allocation_summary> summaries;
+    summaries.reserve(types().size());
+    for (const type_entry* type : types())
+    {
+        allocation_summary& summary = summaries.emplace_back();
+        summary.type = type->name;
+        summary.element_size = type->element_size;
+        type->retired.add_to(summary);
+        for (const counters* thread : type->threads)
+        {
+            thread->add_to(summary);
+        }
+    }
+    return summaries;
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::allocate(size_type count) -> T*
+{
+    allocation_stats::enroll<T>();
+    T* data = upstream_traits::allocate(upstream, count);
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { counts.allocated(count * sizeof(T)); });
+    return data;
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::allocate_at_least(size_type count) -> allocation_result
+    requires requires (Upstream& upstream, size_type count) { upstream.allocate_at_least(count); }
+{
+    allocation_stats::enroll<T>();
+    auto [data, received] = upstream.allocate_at_least(count);
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { counts.allocated(received * sizeof(T)); });
+    return { data, received };
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::deallocate(T* data, size_type count) noexcept -> void
+{
+    upstream_traits::deallocate(upstream, data, count);
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { counts.deallocated(count * sizeof(T)); });
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::expand(T* data, size_type capacity, size_type count) -> size_type
+    requires requires (Upstream& upstream, T* data, size_type count) { upstream.expand(data, count, count); }
+{
+    allocation_stats::enroll<T>();
+    const size_type expanded = upstream.expand(data, capacity, count);
+    if (expanded != 0)
+    {
+        allocation_stats::record<T>([&](allocation_stats::counters& counts) { counts.resized(capacity * sizeof(T), expanded * sizeof(T)); });
+    }
+    return expanded;
+};
+
+/*
+    Counted as freeing the old block and allocating the new one, dynamic_buffer records the reallocation itself.
+*/
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::reallocate(T* data, size_type capacity, size_type count) -> allocation_result
+    requires requires (Upstream& upstream, T* data, size_type count) { upstream.reallocate(data, count, count); }
+{
+    allocation_stats::enroll<T>();
+    auto [new_data, received] = upstream.reallocate(data, capacity, count);
+    allocation_stats::record<T>([&](allocation_stats::counters& counts)
+    {
+        counts.deallocated(capacity * sizeof(T));
+        counts.allocated(received * sizeof(T));
+    });
+    return { new_data, received };
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::record_copies(size_type count) noexcept -> void
+{
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { allocation_stats::bump<std::uint64_t>(counts.copies, count); });
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::record_moves(size_type count) noexcept -> void
+{
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { allocation_stats::bump<std::uint64_t>(counts.moves, count); });
+};
+
+template <typename T, typename Upstream>
+auto instrumented_allocator<T, Upstream>::record_reallocation() noexcept -> void
+{
+    allocation_stats::record<T>([&](allocation_stats::counters& counts) { allocation_stats::bump<std::uint64_t>(counts.reallocations, 1); });
+};
+
+/*
+    The counts of every type an instrumented_allocator has allocated, summed over all threads.
+*/
+inline auto allocation_report() -> std::vector<allocation_summary>
+{
+    return allocation_stats::report();
+};
+
+/*
+    One line per type, most live bytes first.
+*/
+inline auto log_allocation_report(std::vector<allocation_summary> report, spdlog::logger& logger, spdlog::level::level_enum level = spdlog::level::info) -> void
+{
+    std::ranges::sort(report, std::ranges::greater{}, &allocation_summary::live_bytes);
+    for (const allocation_summary& summary : report)
+    {
+        logger.log(level, "{}: {} allocations, {} deallocations, {} reallocations, {} bytes allocated, {} live, {} peak, {} copies, {} moves",
+            summary.type, summary.allocations, summary.deallocations, summary.reallocations, summary.bytes_allocated,
+            summary.live_bytes, summary.peak_live_bytes, summary.copies, summary.moves);
+    }
+};
+
+inline auto log_allocation_report(std::vector<allocation_summary> report) -> void
+{
+    log_allocation_report(std::move(report), *spdlog::default_logger());
+};
+
+/*
+    {"types":[{"type":"int","element_size":4,...,"sizes":{"64":3,"4096":1}}]}
+    sizes only holds the buckets that were used, keyed by their upper limit in bytes.
+*/
+inline auto allocation_report_json(const std::vector<allocation_summary>& report) -> std::string
+{
+    std::string json = "{\"types\":[";
+    for (std::size_t i = 0; i < report.size(); ++i)
+    {
+        const allocation_summary& summary = report[i];
+        std::string type;
+        for (char c : summary.type)
+        {
+            if (c == '"' or c == '\\')
+            {
+                type.push_back('\\');
+            }
+            type.push_back(c);
+        }
+
+        fmt::format_to(std::back_inserter(json),
+            "{}{{\"type\":\"{}\",\"element_size\":{},\"allocations\":{},\"deallocations\":{},\"reallocations\":{},"
+            "\"bytes_allocated\":{},\"live_bytes\":{},\"peak_live_bytes\":{},\"copies\":{},\"moves\":{},\"sizes\":{{",
+            i == 0 ? "" : ",", type, summary.element_size, summary.allocations, summary.deallocations, summary.reallocations,
+            summary.bytes_allocated, summary.live_bytes, summary.peak_live_bytes, summary.copies, summary.moves);
+        bool first = true;
+        for (std::size_t bucket = 0; bucket < allocation_summary::bucket_count; ++bucket)
+        {
+            if (summary.sizes[bucket] != 0)
+            {
+                fmt::format_to(std::back_inserter(json), "{}\"{}\":{}", first ? "" : ",", allocation_summary::bucket_limit(bucket), summary.sizes[bucket]);
+                first = false;
+            }
+        }
+        json += "}}";
+    }
+    json += "]}";
+    return json;
+};
+
+/*
+    Hands allocation_report() to a callback every interval on a background thread, and once more when destroyed.
+    The callback logs to the default spdlog logger unless another one is given.
+*/
+struct allocation_reporter
+{
+    using callback_type = std::function<void(std::vector<allocation_summary>)>;
+
+    std::chrono::milliseconds interval;
+    callback_type callback;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    std::thread reporter;
+
+    explicit allocation_reporter(std::chrono::milliseconds interval, callback_type callback = [](std::vector<allocation_summary> report) { log_allocation_report(std::move(report)); });
+    allocation_reporter(const allocation_reporter&) = delete;
+    ~allocation_reporter();
+
+    auto operator =(const allocation_reporter&) -> allocation_reporter& = delete;
+
+    auto run() -> void;
+};
+
+inline allocation_reporter::allocation_reporter(std::chrono::milliseconds interval, callback_type callback) :
+    interval{ interval },
+    callback{ std::move(callback) }
+{
+    reporter = std::thread{ [this] { run(); } };
+};
+
+inline allocation_reporter::~allocation_reporter()
+{
+    {
+        std::lock_guard lock{ mutex };
+        stopping = true;
+    }
+    wake.notify_one();
+    reporter.join();
+    callback(allocation_report());
+};
+
+inline auto allocation_reporter::run() -> void
+{
+    std::unique_lock lock{ mutex };
+    while (not wake.wait_for(lock, interval, [this] { return stopping; }))
+    {
+        lock.unlock();
+        callback(allocation_report());
+        lock.lock();
+    }
+};
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <cerrno>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+#ifndef CONTAINERS_HAS_MMAN
+#if __has_include(<sys/mman.h>)
+#define CONTAINERS_HAS_MMAN 1
+#else
+#define CONTAINERS_HAS_MMAN 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_MMAN
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+    A buffer over a memory mapped file.
+    Cannot be resized, the length is however many whole elements the file holds.
+
+    Pages are read in by the kernel on first touch and shared through the page cache, so opening a
+    large file costs no copy and several processes mapping it share one set of pages.
+    read_only mappings are only for const element types, mapped_buffer<const T>, so nothing can be
+    written through them. copy_on_write mappings keep their writes private and are the default for
+    mutable element types, shared mappings write back to the file.
+    A moved from mapped_buffer holds no elements and may only be assigned to or destroyed.
+*/
+
+enum class map_mode
+{
+    read_only,
+    copy_on_write,
+    shared,
+};
+
+enum class access_hint
+{
+    normal,
+    sequential,
+    random,
+    will_need,
+    dont_need,
+};
+
+template <typename T>
+struct mapped_buffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "a mapped file can only hold trivially copyable elements");
+
+    using value_type = std::remove_const_t<T>;
+    using element_type = T;
+    using size_type = std::size_t;
+    using pointer = element_type*;
+
+    static constexpr map_mode default_mode = std::is_const_v<T> ? map_mode::read_only : map_mode::copy_on_write;
+
+    size_type size = 0;
+    std::size_t bytes = 0;
+    map_mode mode = map_mode::read_only;
+    pointer data = nullptr;
+
+    mapped_buffer() noexcept = default;
+    mapped_buffer(const mapped_buffer&) = delete;
+    mapped_buffer(mapped_buffer&& other) noexcept;
+    ~mapped_buffer();
+    auto operator =(mapped_buffer other) noexcept -> mapped_buffer&;
+
+    explicit mapped_buffer(const std::filesystem::path& path, map_mode mode = default_mode);
+
+    auto operator [](size_type index)       & -> element_type&;
+    auto operator [](size_type index) const & -> const value_type&;
+
+    auto advise(access_hint hint) const -> void;
+    auto advise(access_hint hint, size_type first, size_type count) const -> void;
+    auto sync() const -> void;
+
+    using iterator = std::conditional_t<std::is_const_v<T>, dynamic_buffer_const_iterator<value_type>, dynamic_buffer_iterator<value_type>>;
+    using const_iterator = dynamic_buffer_const_iterator<value_type>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    auto begin() noexcept -> iterator
+    {
+        return iterator{ data };
+    };
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    auto end() noexcept -> iterator
+    {
+        return iterator{ data + size };
+    };
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + size };
+    };
+    auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + size };
+    };
+    auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename T>
+auto swap(mapped_buffer<T>& left, mapped_buffer<T>& right) noexcept -> void
+{
+    using std::swap;
+    swap(left.size, right.size);
+    swap(left.mode, right.mode);
+    swap(left.data, right.data);
+    swap(left.bytes, right.bytes);
+};
+
+template <typename T>
+mapped_buffer<T>::mapped_buffer(mapped_buffer&& other) noexcept
+{
+    swap(*this, other);
+};
+
+template <typename T>
+mapped_buffer<T>::~mapped_buffer()
+{
+    if (data)
+    {
+        ::munmap(const_cast<value_type*>(data), bytes);
+    }
+};
+
+template <typename T>
+auto mapped_buffer<T>::operator =(mapped_buffer other) noexcept -> mapped_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+/*
+    Maps the whole file, trailing bytes that do not make up a whole element are mapped but not indexable.
+    A read_only mapping of mutable elements is rejected with std::invalid_argument, writing through it would fault.
+    Failures are reported as std::system_error carrying errno.
+*/
+template <typename T>
+mapped_buffer<T>::mapped_buffer(const std::filesystem::path& path, map_mode mode) :
+    mode{ mode }
+{
+    if (mode == map_mode::read_only and not std::is_const_v<T>)
+    {
+        throw std::invalid_argument{ "read_only mappings need a const element type" };
+    }
+
+    const int descriptor = ::open(path.c_str(), (mode == map_mode::shared ? O_RDWR : O_RDONLY) | O_CLOEXEC);
+    if (descriptor < 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), path.string() };
+    }
+
+    struct ::stat status{};
+    if (::fstat(descriptor, &status) != 0)
+    {
+        const int error = errno;
+        ::close(descriptor);
+        throw std::system_error{ error, std::generic_category(), path.string() };
+    }
+
+    bytes = static_cast<std::size_t>(status.st_size);
+    size = bytes / sizeof(T);
+    if (bytes > 0)
+    {
+        const int protection = mode == map_mode::read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        const int flags = mode == map_mode::shared ? MAP_SHARED : MAP_PRIVATE;
+        void* region = ::mmap(nullptr, bytes, protection, flags, descriptor, 0);
+        if (region == MAP_FAILED)
+        {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error{ error, std::generic_category(), path.string() };
+        }
+        data = static_cast<pointer>(region);
+    }
+
+    // the mapping holds its own reference to the file.
+    ::close(descriptor);
+};
+
+template <typename T>
+auto mapped_buffer<T>::operator [](size_type index) & -> element_type&
+{
+    check_index(index, size);
+
+    return data[index];
+};
+
+template <typename T>
+auto mapped_buffer<T>::operator [](size_type index) const& -> const value_type&
+{
+    check_index(index, size);
+
+    return data[index];
+};
+
+template <typename T>
+auto mapped_buffer<T>::advise(access_hint hint) const -> void
+{
+    advise(hint, 0, size);
+};
+
+/*
+    Tells the kernel how the elements in [first, first + count) are about to be used.
+    The range is widened to whole pages.
+    dont_need is rejected on copy_on_write mappings, dropping their pages would throw away the private writes.
+*/
+template <typename T>
+auto mapped_buffer<T>::advise(access_hint hint, size_type first, size_type count) const -> void
+{
+    contract;
+        pre(first <= size);
+        pre(count <= size - first);
+
+    if (hint == access_hint::dont_need and mode == map_mode::copy_on_write)
+    {
+        throw std::invalid_argument{ "dont_need would discard the writes to a copy_on_write mapping" };
+    }
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    int advice = MADV_NORMAL;
+    switch (hint)
+    {
+    case access_hint::normal:     advice = MADV_NORMAL;     break;
+    case access_hint::sequential: advice = MADV_SEQUENTIAL; break;
+    case access_hint::random:     advice = MADV_RANDOM;     break;
+    case access_hint::will_need:  advice = MADV_WILLNEED;   break;
+    case access_hint::dont_need:  advice = MADV_DONTNEED;   break;
+    }
+
+    const auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+    const auto begin = reinterpret_cast<std::uintptr_t>(data + first) & ~(page - 1);
+    const auto end = reinterpret_cast<std::uintptr_t>(data + first + count);
+    if (::madvise(reinterpret_cast<void*>(begin), end - begin, advice) != 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), "madvise" };
+    }
+};
+
+/*
+    Writes a shared mapping back to the file and waits for it to finish.
+*/
+template <typename T>
+auto mapped_buffer<T>::sync() const -> void
+{
+    if (data and mode == map_mode::shared and ::msync(const_cast<value_type*>(data), bytes, MS_SYNC) != 0)
+    {
+        throw std::system_error{ errno, std::generic_category(), "msync" };
+    }
+};
+
+template <typename T>
+auto operator ==(const mapped_buffer<T>& left, const mapped_buffer<T>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    return equal_elements(left.data, right.data, left.size);
+};
+
+template <typename T>
+auto operator <=>(const mapped_buffer<T>& left, const mapped_buffer<T>& right) noexcept -> std::partial_ordering
+{
+    return compare_elements(left.data, left.size, right.data, right.size);
+};
+
+template <typename T>
+using mapped_buffer_iterator = typename mapped_buffer<T>::iterator;
+
+template <typename T>
+using mapped_buffer_const_iterator = typename mapped_buffer<T>::const_iterator;
+
+template <typename T>
+using mapped_buffer_reverse_iterator = typename mapped_buffer<T>::reverse_iterator;
+
+template <typename T>
+using mapped_buffer_const_reverse_iterator = typename mapped_buffer<T>::const_reverse_iterator;
+#endif
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+#include "static_buffer.hpp"
+#include "tiled_layouts.hpp"
+
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+#ifndef CONTAINERS_HAS_MDSPAN
+#if defined(__cpp_lib_mdspan)
+#define CONTAINERS_HAS_MDSPAN 1
+#else
+#define CONTAINERS_HAS_MDSPAN 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_MDSPAN
+
+/*
+    Multidimensional views over the buffers, and a matrix that owns its storage.
+
+    as_mdspan<Layout>(buffer, extents...) views a buffer as a std::mdspan with the given extents,
+    which must fit within the buffer. Layout defaults to std::layout_right, the usual row * width + column.
+    Kernels written against std::mdspan work with any layout, so switching to layout_tiled or layout_morton
+    only changes where the view is made.
+    Needs a standard library with std::mdspan, like tiled_layouts.hpp, and is empty otherwise.
+*/
+
+template <typename Layout, typename T, typename I, std::size_t... Es>
+constexpr auto view_elements(T* data, std::size_t size, const std::extents<I, Es...>& extents) -> std::mdspan<T, std::extents<I, Es...>, Layout>
+{
+    using mapping_type = typename Layout::template mapping<std::extents<I, Es...>>;
+
+    contract;
+        pre(static_cast<std::size_t>(mapping_type{ extents }.required_span_size()) <= size);
+
+    return { data, mapping_type{ extents } };
+};
+
+template <typename Layout = std::layout_right, typename T, typename A, typename I, std::size_t... Es>
+constexpr auto as_mdspan(dynamic_buffer<T, A>& buffer, const std::extents<I, Es...>& extents) -> std::mdspan<T, std::extents<I, Es...>, Layout>
+{
+    return view_elements<Layout, T>(std::to_address(buffer.data), buffer.size, extents);
+};
+
+template <typename Layout = std::layout_right, typename T, typename A, typename I, std::size_t... Es>
+constexpr auto as_mdspan(const dynamic_buffer<T, A>& buffer, const std::extents<I, Es...>& extents) -> std::mdspan<const T, std::extents<I, Es...>, Layout>
+{
+    return view_elements<Layout, const T>(std::to_address(buffer.data), buffer.size, extents);
+};
+
+template <typename Layout = std::layout_right, typename T, std::size_t N, typename A, typename I, std::size_t... Es>
+constexpr auto as_mdspan(static_buffer<T, N, A>& buffer, const std::extents<I, Es...>& extents) -> std::mdspan<T, std::extents<I, Es...>, Layout>
+{
+    return view_elements<Layout, T>(std::to_address(buffer.data), N, extents);
+};
+
+template <typename Layout = std::layout_right, typename T, std::size_t N, typename A, typename I, std::size_t... Es>
+constexpr auto as_mdspan(const static_buffer<T, N, A>& buffer, const std::extents<I, Es...>& extents) -> std::mdspan<const T, std::extents<I, Es...>, Layout>
+{
+    return view_elements<Layout, const T>(std::to_address(buffer.data), N, extents);
+};
+
+template <typename Layout = std::layout_right, typename Buffer, std::integral... Is>
+    requires (sizeof...(Is) > 0)
+constexpr auto as_mdspan(Buffer& buffer, Is... extents)
+{
+    return as_mdspan<Layout>(buffer, std::dextents<std::size_t, sizeof...(Is)>{ static_cast<std::size_t>(extents)... });
+};
+
+/*
+    A rows x columns matrix laid out by Layout, in a dynamic_buffer holding exactly the layout's
+    required span. Padding a tiled or Z-order layout needs is constructed like any other element.
+    Cannot be resized, a matrix of a different shape needs a different layout.
+*/
+
+template <typename T, typename Layout = std::layout_right, typename A = std::allocator<T>>
+struct matrix_buffer
+{
+    using elements = dynamic_buffer<T, A>;
+    using allocator_type = typename elements::allocator_type;
+    using value_type = T;
+    using size_type = std::size_t;
+    using extents_type = std::dextents<size_type, 2>;
+    using layout_type = Layout;
+    using mapping_type = typename Layout::template mapping<extents_type>;
+    using view_type = std::mdspan<T, extents_type, Layout>;
+    using const_view_type = std::mdspan<const T, extents_type, Layout>;
+
+    mapping_type mapping = {};
+    elements storage = {};
+
+    constexpr matrix_buffer() = default;
+
+    template <typename... Args>
+    constexpr matrix_buffer(size_type rows, size_type columns, Args&&... arguments) :
+        mapping{ extents_type{ rows, columns } },
+        storage(static_cast<size_type>(mapping.required_span_size()), std::forward<Args>(arguments)...)
+    {};
+    constexpr matrix_buffer(uninitialized_t, size_type rows, size_type columns) :
+        mapping{ extents_type{ rows, columns } },
+        storage(uninitialized, static_cast<size_type>(mapping.required_span_size()))
+    {};
+    template <typename... Args>
+    constexpr matrix_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type rows, size_type columns, Args&&... arguments) :
+        mapping{ extents_type{ rows, columns } },
+        storage(std::allocator_arg, allocator, static_cast<size_type>(mapping.required_span_size()), std::forward<Args>(arguments)...)
+    {};
+
+    constexpr auto rows() const noexcept -> size_type
+    {
+        return mapping.extents().extent(0);
+    };
+    constexpr auto columns() const noexcept -> size_type
+    {
+        return mapping.extents().extent(1);
+    };
+
+    constexpr auto operator [](size_type row, size_type column) noexcept -> value_type&;
+    constexpr auto operator [](size_type row, size_type column) const noexcept -> const value_type&;
+
+    constexpr auto view() noexcept -> view_type
+    {
+        return { std::to_address(storage.data), mapping };
+    };
+    constexpr auto view() const noexcept -> const_view_type
+    {
+        return { std::to_address(storage.data), mapping };
+    };
+};
+
+template <typename T, std::size_t TileRows, std::size_t TileColumns = TileRows, typename A = std::allocator<T>>
+using tiled_matrix_buffer = matrix_buffer<T, layout_tiled<TileRows, TileColumns>, A>;
+template <typename T, typename A = std::allocator<T>>
+using morton_matrix_buffer = matrix_buffer<T, layout_morton, A>;
+
+template <typename T, typename L, typename A>
+constexpr auto matrix_buffer<T, L, A>::operator [](size_type row, size_type column) noexcept -> value_type&
+{
+    check_index(row, rows());
+    check_index(column, columns());
+
+    return storage.data[mapping(row, column)];
+};
+
+template <typename T, typename L, typename A>
+constexpr auto matrix_buffer<T, L, A>::operator [](size_type row, size_type column) const noexcept -> const value_type&
+{
+    check_index(row, rows());
+    check_index(column, columns());
+
+    return storage.data[mapping(row, column)];
+};
+
+template <typename T, typename L, typename A>
+constexpr auto operator ==(const matrix_buffer<T, L, A>& left, const matrix_buffer<T, L, A>& right) noexcept -> bool
+{
+    return left.mapping == right.mapping and left.storage == right.storage;
+};
+#endif
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "aligned_allocator.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A bounded lock free queue for any number of producer and consumer threads.
+
+    Every slot carries a sequence number saying whose turn it is: a slot at position pos is free for the
+    producer of pos when its sequence is pos, and holds a value for the consumer of pos when it is pos + 1.
+    The try_ operations claim a position only once its slot is ready, with a compare exchange.
+    push and pop take the next position outright and sleep on the slot's sequence until their turn comes.
+    Slots sit on cache lines of their own, in a dynamic_buffer from aligned_allocator.
+*/
+
+template <typename T>
+struct mpmc_queue
+{
+    using value_type = T;
+    using size_type = std::size_t;
+
+    static constexpr std::size_t cache_line = 64;
+
+    struct alignas(cache_line) slot
+    {
+        std::atomic<size_type> sequence = 0;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        auto element() noexcept -> T*
+        {
+            return std::launder(reinterpret_cast<T*>(storage));
+        };
+    };
+
+    dynamic_buffer<slot, aligned_allocator<slot, cache_line>> slots;
+    size_type mask = 0;
+
+    alignas(cache_line) std::atomic<size_type> enqueue_position = 0;
+    alignas(cache_line) std::atomic<size_type> dequeue_position = 0;
+
+    explicit mpmc_queue(size_type capacity);
+    mpmc_queue(const mpmc_queue&) = delete;
+    ~mpmc_queue();
+    auto operator =(const mpmc_queue&) -> mpmc_queue& = delete;
+
+    template <typename... Args>
+    auto try_push(Args&&... arguments) -> bool;
+    auto try_pop(value_type& value) -> bool;
+
+    template <typename... Args>
+    auto push(Args&&... arguments) -> void;
+    auto pop() -> value_type;
+
+    auto capacity() const noexcept -> size_type
+    {
+        return mask + 1;
+    };
+    // exact only when no thread is running.
+    auto size() const noexcept -> size_type
+    {
+        const size_type enqueued = enqueue_position.load(std::memory_order_acquire);
+        const size_type dequeued = dequeue_position.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    };
+
+    static auto publish(slot& target, size_type sequence) noexcept -> void;
+    static auto wait_for(slot& target, size_type sequence) noexcept -> void;
+
+    // ends the element in a slot and hands the slot on, even when moving the element out throws.
+    struct consumed
+    {
+        slot& target;
+        size_type sequence;
+
+        ~consumed()
+        {
+            std::destroy_at(target.element());
+            publish(target, sequence);
+        };
+    };
+};
+
+/*
+    The capacity is rounded up to a power of two, and to at least two.
+*/
+template <typename T>
+mpmc_queue<T>::mpmc_queue(size_type capacity) :
+    slots(std::bit_ceil(std::max<size_type>(capacity, 2))),
+    mask{ slots.size - 1 }
+{
+    for (size_type i = 0; i < slots.size; ++i)
+    {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+};
+
+template <typename T>
+mpmc_queue<T>::~mpmc_queue()
+{
+    const size_type enqueued = enqueue_position.load(std::memory_order_relaxed);
+    for (size_type position = dequeue_position.load(std::memory_order_relaxed); position < enqueued; ++position)
+    {
+        std::destroy_at(slots[position & mask].element());
+    }
+};
+
+template <typename T>
+auto mpmc_queue<T>::publish(slot& target, size_type sequence) noexcept -> void
+{
+    target.sequence.store(sequence, std::memory_order_release);
+    target.sequence.notify_all();
+};
+
+template <typename T>
+auto mpmc_queue<T>::wait_for(slot& target, size_type sequence) noexcept -> void
+{
+    for (size_type current = target.sequence.load(std::memory_order_acquire); current != sequence; current = target.sequence.load(std::memory_order_acquire))
+    {
+        target.sequence.wait(current, std::memory_order_acquire);
+    }
+};
+
+/*
+    Returns false when the queue is full.
+    A position cannot be given back once claimed, so a value whose construction may throw is built
+    before claiming one and then moved in.
+*/
+template <typename T>
+template <typename... Args>
+auto mpmc_queue<T>::try_push(Args&&... arguments) -> bool
+{
+    if constexpr (not std::is_nothrow_constructible_v<T, Args&&...>)
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "values must be movable without throwing");
+        return try_push(T(std::forward<Args>(arguments)...));
+    }
+
+    size_type position = enqueue_position.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot& target = slots[position & mask];
+        const auto difference = static_cast<std::intptr_t>(target.sequence.load(std::memory_order_acquire) - position);
+        if (difference == 0)
+        {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                std::construct_at(target.element(), std::forward<Args>(arguments)...);
+                publish(target, position + 1);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+/*
+    Returns false when the queue is empty.
+    If moving the value out throws, it is lost and the exception propagates.
+*/
+template <typename T>
+auto mpmc_queue<T>::try_pop(value_type& value) -> bool
+{
+    size_type position = dequeue_position.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot& target = slots[position & mask];
+        const auto difference = static_cast<std::intptr_t>(target.sequence.load(std::memory_order_acquire) - (position + 1));
+        if (difference == 0)
+        {
+            if (dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                const consumed release{ target, position + mask + 1 };
+                value = std::move(*target.element());
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = dequeue_position.load(std::memory_order_relaxed);
+        }
+    }
+};
+
+/*
+    Blocks while the queue is full, the same as try_push otherwise.
+*/
+template <typename T>
+template <typename... Args>
+auto mpmc_queue<T>::push(Args&&... arguments) -> void
+{
+    if constexpr (not std::is_nothrow_constructible_v<T, Args&&...>)
+    {
+        static_assert(std::is_nothrow_move_constructible_v<T>, "values must be movable without throwing");
+        return push(T(std::forward<Args>(arguments)...));
+    }
+
+    const size_type position = enqueue_position.fetch_add(1, std::memory_order_relaxed);
+    slot& target = slots[position & mask];
+    wait_for(target, position);
+    std::construct_at(target.element(), std::forward<Args>(arguments)...);
+    publish(target, position + 1);
+};
+
+/*
+    Blocks while the queue is empty, the same as try_pop otherwise.
+*/
+template <typename T>
+auto mpmc_queue<T>::pop() -> value_type
+{
+    const size_type position = dequeue_position.fetch_add(1, std::memory_order_relaxed);
+    slot& target = slots[position & mask];
+    wait_for(target, position + 1);
+
+    const consumed release{ target, position + mask + 1 };
+    return std::move(*target.element());
+};
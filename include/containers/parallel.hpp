@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+    Selects the overloads that split element work across threads.
+    Each thread builds, and so first touches, its own slice of the storage, which spreads the pages of
+    a large buffer over the memory of every socket the threads run on.
+    threads == 0 uses one thread per hardware thread.
+*/
+struct parallel_t
+{
+    std::size_t threads = 0;
+
+    constexpr explicit parallel_t() = default;
+    constexpr explicit parallel_t(std::size_t threads) : threads{ threads } {};
+};
+constexpr parallel_t parallel{};
+
+/*
+    Runs work(first, last) over slices of [0, count), at most one per thread and none smaller than grain,
+    the last slice on the calling thread.
+    If any slice throws, undo(first, last) is called for every slice that finished and the first
+    exception is rethrown once all threads are joined. A slice that throws must clean up after itself.
+*/
+template <typename Work, typename Undo>
+auto parallel_slices(parallel_t policy, std::size_t count, std::size_t grain, Work&& work, Undo&& undo) -> void
+{
+    grain = std::max<std::size_t>(grain, 1);
+    std::size_t threads = policy.threads ? policy.threads : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    threads = std::clamp<std::size_t>(count / grain, 1, threads);
+    if (threads == 1)
+    {
+        work(std::size_t{ 0 }, count);
+        return;
+    }
+
+    // slice boundaries fall on multiples of grain, so neighbouring threads share at most one page.
+    const std::size_t slice = (count / threads + grain - 1) / grain * grain;
+    std::vector<std::exception_ptr> failures(threads);
+    std::vector<std::thread> workers{};
+    workers.reserve(threads - 1);
+
+    auto bounds = [&](std::size_t i)
+    {
+        return std::pair{ std::min(i * slice, count), i + 1 == threads ? count : std::min((i + 1) * slice, count) };
+    };
+    auto run = [&](std::size_t i) noexcept
+    {
+        try
+        {
+            const auto [first, last] = bounds(i);
+            if (first < last)
+            {
+                work(first, last);
+            }
+        }
+        catch (...)
+        {
+            failures[i] = std::current_exception();
+        }
+    };
+
+    for (std::size_t i = 0; i + 1 < threads; ++i)
+    {
+        try
+        {
+            workers.emplace_back(run, i);
+        }
+        catch (...)
+        {
+            // out of threads, do the slice here instead.
+            run(i);
+        }
+    }
+    run(threads - 1);
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    const auto failed = std::find_if(failures.begin(), failures.end(), [](const std::exception_ptr& failure) { return failure != nullptr; });
+    if (failed == failures.end())
+    {
+        return;
+    }
+
+    for (std::size_t i = 0; i < threads; ++i)
+    {
+        if (const auto [first, last] = bounds(i); not failures[i] and first < last)
+        {
+            undo(first, last);
+        }
+    }
+    std::rethrow_exception(*failed);
+};
@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+/*
+    Power of two size classes from 16 bytes to 64 KiB, shared by every pool_allocator.
+
+    Each thread keeps a freelist per class and only touches the shared lists, one mutex per class,
+    to refill an empty freelist or hand back half of a full one, a batch at a time.
+    Retention is bounded on both levels, blocks beyond the limits go back to operator delete.
+    A block freed on another thread joins the freeing thread's lists, once a thread's cache is gone
+    its frees go straight to the shared lists.
+*/
+
+struct size_class_pool
+{
+    static constexpr std::size_t min_block = 16;
+    static constexpr std::size_t max_block = std::size_t{ 64 } << 10;
+    static constexpr std::size_t class_count = 13;
+    static constexpr std::size_t cache_bytes = std::size_t{ 256 } << 10;
+    static constexpr std::size_t shared_bytes = std::size_t{ 4 } << 20;
+
+    static constexpr auto class_of(std::size_t bytes) noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(std::bit_width(std::max(bytes, min_block) - 1)) - 4;
+    };
+    static constexpr auto block_size(std::size_t index) noexcept -> std::size_t
+    {
+        return min_block << index;
+    };
+    static constexpr auto cache_limit(std::size_t index) noexcept -> std::size_t
+    {
+        return std::max<std::size_t>(cache_bytes / block_size(index), 8);
+    };
+    static constexpr auto shared_limit(std::size_t index) noexcept -> std::size_t
+    {
+        return std::max<std::size_t>(shared_bytes / block_size(index), 64);
+    };
+
+    static auto allocate(std::size_t index) -> void*;
+    static auto deallocate(void* block, std::size_t index) noexcept -> void;
+
+    struct node
+    {
+        node* next;
+    };
+    struct freelist
+    {
+        node* head = nullptr;
+        std::size_t count = 0;
+
+        auto push(void* block) noexcept -> void;
+        auto pop() noexcept -> void*;
+    };
+    struct shared_list
+    {
+        std::mutex mutex;
+        freelist list;
+    };
+    struct local_cache
+    {
+        freelist lists[class_count];
+
+        ~local_cache();
+    };
+
+    static inline thread_local constinit bool cache_finished = false;
+
+    static auto shared(std::size_t index) noexcept -> shared_list&;
+    static auto local() noexcept -> local_cache*;
+    static auto give_back(std::size_t index, freelist& list, std::size_t count) noexcept -> void;
+};
+
+/*
+    Allocates from size_class_pool, rounding each request up to its size class and
+    reporting the rounded size through allocate_at_least.
+    Requests above the largest class go straight to operator new.
+*/
+template <typename T>
+struct pool_allocator
+{
+    static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "pooled blocks only have the default new alignment");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    struct allocation_result
+    {
+        T* ptr = nullptr;
+        size_type count = 0;
+    };
+
+    constexpr pool_allocator() noexcept = default;
+    template <typename U>
+    constexpr pool_allocator(const pool_allocator<U>&) noexcept {};
+
+    auto allocate(size_type count) -> T*;
+    auto allocate_at_least(size_type count) -> allocation_result;
+    auto deallocate(T* data, size_type count) noexcept -> void;
+
+    template <typename U>
+    constexpr auto operator ==(const pool_allocator<U>&) const noexcept -> bool
+    {
+        return true;
+    };
+};
+
+inline auto size_class_pool::freelist::push(void* block) noexcept -> void
+{
+    head = ::new (block) node{ head };
+    ++count;
+};
+
+inline auto size_class_pool::freelist::pop() noexcept -> void*
+{
+    node* block = head;
+    head = block->next;
+    --count;
+    return block;
+};
+
+/*
+    Never destroyed, blocks may still be returned while other statics are torn down.
+*/
+inline auto size_class_pool::shared(std::size_t index) noexcept -> shared_list&
+{
+    static shared_list* lists = new shared_list[class_count];
+    return lists[index];
+};
+
+/*
+    Null once the thread's cache has been destroyed.
+*/
+inline auto size_class_pool::local() noexcept -> local_cache*
+{
+    if (cache_finished)
+    {
+        return nullptr;
+    }
+
+    thread_local local_cache cache;
+    return &cache;
+};
+
+inline size_class_pool::local_cache::~local_cache()
+{
+    cache_finished = true;
+    for (std::size_t i = 0; i < class_count; ++i)
+    {
+        give_back(i, lists[i], lists[i].count);
+    }
+};
+
+/*
+    Moves count blocks from list to the shared list, releasing whatever does not fit.
+*/
+inline auto size_class_pool::give_back(std::size_t index, freelist& list, std::size_t count) noexcept -> void
+{
+    freelist surplus{};
+    {
+        shared_list& target = shared(index);
+        std::lock_guard lock{ target.mutex };
+        for (; count > 0; --count)
+        {
+            freelist& destination = target.list.count < shared_limit(index) ? target.list : surplus;
+            destination.push(list.pop());
+        }
+    }
+
+    while (surplus.head)
+    {
+        ::operator delete(surplus.pop(), block_size(index));
+    }
+};
+
+inline auto size_class_pool::allocate(std::size_t index) -> void*
+{
+    if (local_cache* cache = local())
+    {
+        freelist& list = cache->lists[index];
+        if (not list.head)
+        {
+            shared_list& source = shared(index);
+            std::lock_guard lock{ source.mutex };
+            for (std::size_t count = cache_limit(index) / 2; count > 0 and source.list.head; --count)
+            {
+                list.push(source.list.pop());
+            }
+        }
+        if (list.head)
+        {
+            return list.pop();
+        }
+    }
+    else
+    {
+        shared_list& source = shared(index);
+        std::lock_guard lock{ source.mutex };
+        if (source.list.head)
+        {
+            return source.list.pop();
+        }
+    }
+
+    return ::operator new(block_size(index));
+};
+
+inline auto size_class_pool::deallocate(void* block, std::size_t index) noexcept -> void
+{
+    if (local_cache* cache = local())
+    {
+        freelist& list = cache->lists[index];
+        list.push(block);
+        if (list.count > cache_limit(index))
+        {
+            give_back(index, list, list.count / 2);
+        }
+        return;
+    }
+
+    freelist single{};
+    single.push(block);
+    give_back(index, single, 1);
+};
+
+template <typename T>
+auto pool_allocator<T>::allocate(size_type count) -> T*
+{
+    return allocate_at_least(count).ptr;
+};
+
+template <typename T>
+auto pool_allocator<T>::allocate_at_least(size_type count) -> allocation_result
+{
+    if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    const std::size_t bytes = count * sizeof(T);
+    if (bytes > size_class_pool::max_block)
+    {
+        return { static_cast<T*>(::operator new(bytes)), count };
+    }
+
+    const std::size_t index = size_class_pool::class_of(bytes);
+    return { static_cast<T*>(size_class_pool::allocate(index)), size_class_pool::block_size(index) / sizeof(T) };
+};
+
+/*
+    count may be anything from the requested count to the one allocate_at_least reported,
+    both land in the same size class.
+*/
+template <typename T>
+auto pool_allocator<T>::deallocate(T* data, size_type count) noexcept -> void
+{
+    const std::size_t bytes = count * sizeof(T);
+    if (bytes > size_class_pool::max_block)
+    {
+        ::operator delete(data, bytes);
+        return;
+    }
+
+    size_class_pool::deallocate(data, size_class_pool::class_of(bytes));
+};
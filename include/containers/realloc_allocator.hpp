@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <limits>
+#include <type_traits>
+
+/*
+    An allocator backed by malloc and realloc.
+    Lets dynamic_buffer grow trivially relocatable elements without copying them itself,
+    realloc can extend the block in place or, for large blocks, remap its pages.
+    Reports exactly the requested count as capacity, any slack malloc keeps past it is not ours to use.
+*/
+
+template <typename T>
+struct realloc_allocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t), "malloc only guarantees fundamental alignment");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using propagate_on_container_move_assignment = std::true_type;
+    using is_always_equal = std::true_type;
+
+    struct allocation_result
+    {
+        T* ptr = nullptr;
+        size_type count = 0;
+    };
+
+    constexpr realloc_allocator() noexcept = default;
+    template <typename U>
+    constexpr realloc_allocator(const realloc_allocator<U>&) noexcept {};
+
+    auto allocate(size_type count) -> T*;
+    auto allocate_at_least(size_type count) -> allocation_result;
+    auto deallocate(T* data, size_type count) noexcept -> void;
+    auto reallocate(T* data, size_type capacity, size_type count) -> allocation_result;
+
+    template <typename U>
+    constexpr auto operator ==(const realloc_allocator<U>&) const noexcept -> bool
+    {
+        return true;
+    };
+};
+
+template <typename T>
+auto realloc_allocator<T>::allocate(size_type count) -> T*
+{
+    if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    void* data = std::malloc(count * sizeof(T));
+    if (not data)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return static_cast<T*>(data);
+};
+
+template <typename T>
+auto realloc_allocator<T>::allocate_at_least(size_type count) -> allocation_result
+{
+    T* data = allocate(count);
+    return { data, count };
+};
+
+template <typename T>
+auto realloc_allocator<T>::deallocate(T* data, size_type) noexcept -> void
+{
+    std::free(data);
+};
+
+template <typename T>
+auto realloc_allocator<T>::reallocate(T* data, size_type, size_type count) -> allocation_result
+{
+    if (count > std::numeric_limits<size_type>::max() / sizeof(T))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    void* new_data = std::realloc(data, count * sizeof(T));
+    if (not new_data)
+    {
+        throw std::bad_alloc{};
+    }
+
+    return { static_cast<T*>(new_data), count };
+};
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A buffer stored as fixed size chunks, found through a directory of chunk pointers.
+    Can only change size when explicitly resized, like dynamic_buffer.
+
+    Resizing only allocates or releases whole chunks, elements are never moved, so their addresses
+    stay valid for as long as they are inside the buffer and growing never needs twice the memory.
+    Only the directory, a dynamic_buffer of pointers, is reallocated, doubling as it goes.
+    Every chunk but the last is full. ChunkSize is a power of two, so indexing is a shift and a mask.
+    segments() gives each chunk as a contiguous span, for loops that should vectorize.
+    A moved from segmented_buffer holds no elements and may only be assigned to or destroyed.
+*/
+
+template <typename T>
+constexpr std::size_t default_chunk_size = std::bit_floor(std::max<std::size_t>((std::size_t{ 1 } << 16) / sizeof(T), 1));
+
+template <typename T, std::size_t ChunkSize = default_chunk_size<T>, typename A = std::allocator<T>>
+struct segmented_buffer
+{
+    static_assert(std::has_single_bit(ChunkSize), "chunks are indexed with a shift and a mask");
+
+    using traits = std::allocator_traits<A>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = typename traits::value_type;
+    using size_type = typename traits::size_type;
+    using pointer = typename traits::pointer;
+    using elements = dynamic_buffer<T, A>;
+    using directory_type = dynamic_buffer<pointer, typename traits::template rebind_alloc<pointer>>;
+
+    static constexpr size_type chunk_size = ChunkSize;
+    static constexpr size_type chunk_shift = std::countr_zero(ChunkSize);
+    static constexpr size_type chunk_mask = ChunkSize - 1;
+
+    size_type size = 0;
+    [[no_unique_address]] allocator_type allocator = {};
+    // slots past chunk_count() are null.
+    directory_type chunks = {};
+
+    segmented_buffer() = default;
+    segmented_buffer(const segmented_buffer& other);
+    segmented_buffer(segmented_buffer&& other) noexcept;
+    ~segmented_buffer();
+    auto operator =(segmented_buffer other) noexcept -> segmented_buffer&;
+
+    template <typename... Args>
+    explicit segmented_buffer(size_type size, Args&&... arguments);
+    explicit segmented_buffer(const allocator_type& allocator) noexcept;
+    template <typename... Args>
+    segmented_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size, Args&&... arguments);
+
+    auto operator [](size_type index) noexcept -> value_type&;
+    auto operator [](size_type index) const noexcept -> const value_type&;
+
+    template <typename... Args>
+    auto resize(size_type size, Args&&... arguments) -> void;
+
+    static constexpr auto chunks_for(size_type count) noexcept -> size_type
+    {
+        return (count + chunk_mask) >> chunk_shift;
+    };
+    auto chunk_count() const noexcept -> size_type
+    {
+        return chunks_for(size);
+    };
+    auto chunk(size_type index) noexcept -> std::span<value_type>;
+    auto chunk(size_type index) const noexcept -> std::span<const value_type>;
+
+    auto segments() noexcept
+    {
+        return std::views::iota(size_type{ 0 }, chunk_count()) | std::views::transform([this](size_type index) { return chunk(index); });
+    };
+    auto segments() const noexcept
+    {
+        return std::views::iota(size_type{ 0 }, chunk_count()) | std::views::transform([this](size_type index) { return chunk(index); });
+    };
+
+    auto release_storage() noexcept -> void;
+
+    template <bool Const>
+    struct segmented_iterator
+    {
+        using value_type = T;
+        using reference_type = std::conditional_t<Const, const T&, T&>;
+        using pointer_type = std::conditional_t<Const, const T*, T*>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        const pointer* directory = nullptr;
+        size_type index = 0;
+
+        constexpr auto operator ==(const segmented_iterator& other) const noexcept -> bool
+        {
+            return index == other.index;
+        };
+        constexpr auto operator <=>(const segmented_iterator& other) const noexcept -> std::strong_ordering
+        {
+            return index <=> other.index;
+        };
+
+        constexpr auto operator *() const -> reference_type
+        {
+            return directory[index >> chunk_shift][index & chunk_mask];
+        };
+        constexpr auto operator ->() const -> pointer_type
+        {
+            return std::addressof(**this);
+        };
+        constexpr auto operator [](difference_type offset) const -> reference_type
+        {
+            return *(*this + offset);
+        };
+
+        constexpr auto operator ++() -> segmented_iterator&
+        {
+            ++index;
+            return *this;
+        };
+        constexpr auto operator ++(int) -> segmented_iterator
+        {
+            segmented_iterator old = *this;
+            ++index;
+            return old;
+        };
+        constexpr auto operator --() -> segmented_iterator&
+        {
+            --index;
+            return *this;
+        };
+        constexpr auto operator --(int) -> segmented_iterator
+        {
+            segmented_iterator old = *this;
+            --index;
+            return old;
+        };
+        constexpr auto operator +=(difference_type offset) -> segmented_iterator&
+        {
+            index += offset;
+            return *this;
+        };
+        constexpr auto operator -=(difference_type offset) -> segmented_iterator&
+        {
+            index -= offset;
+            return *this;
+        };
+        constexpr auto operator +(difference_type offset) const -> segmented_iterator
+        {
+            return { directory, index + offset };
+        };
+        constexpr friend auto operator +(difference_type offset, const segmented_iterator& iter) -> segmented_iterator
+        {
+            return iter + offset;
+        };
+        constexpr auto operator -(difference_type offset) const -> segmented_iterator
+        {
+            return { directory, index - offset };
+        };
+        constexpr auto operator -(const segmented_iterator& other) const -> difference_type
+        {
+            return static_cast<difference_type>(index - other.index);
+        };
+    };
+
+    using iterator = segmented_iterator<false>;
+    using const_iterator = segmented_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    auto begin() noexcept -> iterator
+    {
+        return iterator{ std::to_address(chunks.data), 0 };
+    };
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(chunks.data), 0 };
+    };
+    auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(chunks.data), 0 };
+    };
+    auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    auto end() noexcept -> iterator
+    {
+        return iterator{ std::to_address(chunks.data), size };
+    };
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(chunks.data), size };
+    };
+    auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(chunks.data), size };
+    };
+    auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename T, std::size_t N, typename A>
+auto swap(segmented_buffer<T, N, A>& left, segmented_buffer<T, N, A>& right) noexcept -> void
+{
+    using std::swap;
+
+    swap(left.size, right.size);
+    swap(left.chunks, right.chunks);
+
+    if constexpr (segmented_buffer<T, N, A>::traits::propagate_on_container_swap::value)
+    {
+        swap(left.allocator, right.allocator);
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+segmented_buffer<T, N, A>::segmented_buffer(const segmented_buffer& other) :
+    segmented_buffer{ traits::select_on_container_copy_construction(other.allocator) }
+{
+    chunks.resize(other.chunk_count(), nullptr);
+    try
+    {
+        for (size_type index = 0; index < other.chunk_count(); ++index)
+        {
+            const std::span<const value_type> source = other.chunk(index);
+            size_type capacity = chunk_size;
+            chunks[index] = elements::allocate_storage(allocator, capacity);
+            elements::copy_elements(allocator, chunks[index], source.data(), source.size());
+            size += source.size();
+        }
+    }
+    catch (...)
+    {
+        // the chunk that threw was allocated but holds nothing.
+        if (size < other.size and chunks[chunks_for(size + 1) - 1])
+        {
+            elements::deallocate_storage(allocator, chunks[chunks_for(size + 1) - 1], chunk_size);
+        }
+        release_storage();
+        throw;
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+segmented_buffer<T, N, A>::segmented_buffer(segmented_buffer&& other) noexcept :
+    segmented_buffer{ other.allocator }
+{
+    swap(*this, other);
+};
+
+template <typename T, std::size_t N, typename A>
+segmented_buffer<T, N, A>::~segmented_buffer()
+{
+    release_storage();
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::operator =(segmented_buffer other) noexcept -> segmented_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+template <typename T, std::size_t N, typename A>
+template <typename... Args>
+segmented_buffer<T, N, A>::segmented_buffer(size_type size, Args&&... arguments) :
+    segmented_buffer{ std::allocator_arg, allocator_type{}, size, std::forward<Args>(arguments)... }
+{};
+
+template <typename T, std::size_t N, typename A>
+segmented_buffer<T, N, A>::segmented_buffer(const allocator_type& allocator) noexcept :
+    allocator{ allocator },
+    chunks{ typename directory_type::allocator_type{ allocator } }
+{};
+
+template <typename T, std::size_t N, typename A>
+template <typename... Args>
+segmented_buffer<T, N, A>::segmented_buffer(std::allocator_arg_t, const allocator_type& allocator, size_type size, Args&&... arguments) :
+    segmented_buffer{ allocator }
+{
+    resize(size, std::forward<Args>(arguments)...);
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::operator [](size_type index) noexcept -> value_type&
+{
+    check_index(index, size);
+
+    return chunks.data[index >> chunk_shift][index & chunk_mask];
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::operator [](size_type index) const noexcept -> const value_type&
+{
+    check_index(index, size);
+
+    return chunks.data[index >> chunk_shift][index & chunk_mask];
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::chunk(size_type index) noexcept -> std::span<value_type>
+{
+    check_index(index, chunk_count());
+
+    return { std::to_address(chunks.data[index]), std::min(chunk_size, size - (index << chunk_shift)) };
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::chunk(size_type index) const noexcept -> std::span<const value_type>
+{
+    check_index(index, chunk_count());
+
+    return { std::to_address(chunks.data[index]), std::min(chunk_size, size - (index << chunk_shift)) };
+};
+
+/*
+    Provides the strong exception guarantee, existing elements are never touched when growing.
+    Shrinking releases the chunks that end up empty.
+*/
+template <typename T, std::size_t N, typename A>
+template <typename... Args>
+auto segmented_buffer<T, N, A>::resize(size_type new_size, Args&&... arguments) -> void
+{
+    if (new_size <= size)
+    {
+        const size_type old_size = std::exchange(size, new_size);
+        for (size_type index = chunk_count(); index < chunks_for(old_size); ++index)
+        {
+            elements::destroy_elements(allocator, chunks[index], std::min(chunk_size, old_size - (index << chunk_shift)));
+            elements::deallocate_storage(allocator, chunks[index], chunk_size);
+            chunks[index] = nullptr;
+        }
+        if (chunk_count() > 0 and (new_size & chunk_mask) != 0)
+        {
+            const size_type last = chunk_count() - 1;
+            const size_type kept = new_size - (last << chunk_shift);
+            elements::destroy_elements(allocator, chunks[last] + kept, std::min(chunk_size, old_size - (last << chunk_shift)) - kept);
+        }
+        return;
+    }
+
+    const size_type old_chunks = chunk_count();
+    const size_type new_chunks = chunks_for(new_size);
+    if (new_chunks > chunks.size)
+    {
+        chunks.resize(std::max(new_chunks, chunks.size * 2), nullptr);
+    }
+
+    size_type built = size;
+    try
+    {
+        for (size_type index = old_chunks; index < new_chunks; ++index)
+        {
+            size_type capacity = chunk_size;
+            chunks[index] = elements::allocate_storage(allocator, capacity);
+        }
+        while (built < new_size)
+        {
+            const size_type count = std::min(new_size, (built | chunk_mask) + 1) - built;
+            elements::construct_elements(allocator, chunks[built >> chunk_shift] + (built & chunk_mask), count, arguments...);
+            built += count;
+        }
+    }
+    catch (...)
+    {
+        for (size_type first = size; first < built; )
+        {
+            const size_type count = std::min(built, (first | chunk_mask) + 1) - first;
+            elements::destroy_elements(allocator, chunks[first >> chunk_shift] + (first & chunk_mask), count);
+            first += count;
+        }
+        for (size_type index = old_chunks; index < new_chunks and chunks[index]; ++index)
+        {
+            elements::deallocate_storage(allocator, chunks[index], chunk_size);
+            chunks[index] = nullptr;
+        }
+        throw;
+    }
+    size = new_size;
+};
+
+template <typename T, std::size_t N, typename A>
+auto segmented_buffer<T, N, A>::release_storage() noexcept -> void
+{
+    for (size_type index = 0; index < chunk_count(); ++index)
+    {
+        elements::destroy_elements(allocator, chunks[index], std::min(chunk_size, size - (index << chunk_shift)));
+        elements::deallocate_storage(allocator, chunks[index], chunk_size);
+    }
+    size = 0;
+    chunks.release_storage();
+};
+
+template <typename T, std::size_t N, typename A>
+auto operator ==(const segmented_buffer<T, N, A>& left, const segmented_buffer<T, N, A>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    for (std::size_t index = 0; index < left.chunk_count(); ++index)
+    {
+        const auto lhs = left.chunk(index);
+        if (not equal_elements(lhs.data(), right.chunk(index).data(), lhs.size()))
+        {
+            return false;
+        }
+    }
+    return true;
+};
+
+template <typename T, std::size_t N = default_chunk_size<T>, typename A = std::allocator<T>>
+using segmented_buffer_iterator = typename segmented_buffer<T, N, A>::iterator;
+
+template <typename T, std::size_t N = default_chunk_size<T>, typename A = std::allocator<T>>
+using segmented_buffer_const_iterator = typename segmented_buffer<T, N, A>::const_iterator;
@@ -0,0 +1,311 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    An immutable buffer shared by several owners through one atomic reference count, for handing
+    the same payload to several threads without copying it.
+
+    Freezing a dynamic_buffer takes its storage as it is. Only a small control block holding the count,
+    the allocator and the storage is allocated. Copies and slices share that block. A slice views any
+    sub-range of its parent in O(1) and keeps the whole storage alive. The last owner to go destroys the elements.
+    thaw() turns a shared_buffer back into a dynamic_buffer of the elements it views. It takes the storage
+    without copying when it holds the only reference, and copies the elements otherwise.
+    Owners may be copied and dropped on any thread, the elements are never written while shared.
+    A moved from shared_buffer is empty.
+*/
+
+template <typename T, typename A = std::allocator<T>>
+struct shared_buffer
+{
+    using buffer_type = dynamic_buffer<T, A>;
+    using traits = std::allocator_traits<A>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = typename traits::value_type;
+    using size_type = typename traits::size_type;
+    using pointer = typename traits::pointer;
+
+    struct control_block
+    {
+        std::atomic<size_type> references;
+        [[no_unique_address]] allocator_type allocator;
+        pointer data;
+        size_type size;
+        size_type capacity;
+    };
+    using block_allocator = typename traits::template rebind_alloc<control_block>;
+    using block_traits = std::allocator_traits<block_allocator>;
+
+    const value_type* data = nullptr;
+    size_type size = 0;
+    control_block* block = nullptr;
+
+    shared_buffer() noexcept = default;
+    shared_buffer(const shared_buffer& other) noexcept;
+    shared_buffer(shared_buffer&& other) noexcept;
+    ~shared_buffer();
+    auto operator =(shared_buffer other) noexcept -> shared_buffer&;
+
+    explicit shared_buffer(buffer_type&& buffer);
+
+    auto operator [](size_type index) const -> const value_type&;
+
+    auto slice(size_type offset, size_type count) const & -> shared_buffer;
+    auto slice(size_type offset, size_type count)      && -> shared_buffer;
+    auto thaw() && -> buffer_type;
+    auto release() noexcept -> void;
+
+    auto use_count() const noexcept -> size_type;
+    auto empty() const noexcept -> bool
+    {
+        return size == 0;
+    };
+    auto as_span() const noexcept -> std::span<const value_type>
+    {
+        return { data, size };
+    };
+
+    static auto take_block(control_block* block) noexcept -> buffer_type;
+
+    using iterator = dynamic_buffer_const_iterator<T, A>;
+    using const_iterator = dynamic_buffer_const_iterator<T, A>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + size };
+    };
+    auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + size };
+    };
+    auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+    auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename T, typename A>
+auto swap(shared_buffer<T, A>& left, shared_buffer<T, A>& right) noexcept -> void
+{
+    using std::swap;
+    swap(left.data, right.data);
+    swap(left.size, right.size);
+    swap(left.block, right.block);
+};
+
+template <typename T, typename A>
+shared_buffer<T, A>::shared_buffer(const shared_buffer& other) noexcept :
+    data{ other.data },
+    size{ other.size },
+    block{ other.block }
+{
+    if (block)
+    {
+        // a new owner can only come from an existing one, so nothing needs to be ordered here.
+        block->references.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+template <typename T, typename A>
+shared_buffer<T, A>::shared_buffer(shared_buffer&& other) noexcept
+{
+    swap(*this, other);
+};
+
+template <typename T, typename A>
+shared_buffer<T, A>::~shared_buffer()
+{
+    release();
+};
+
+template <typename T, typename A>
+auto shared_buffer<T, A>::operator =(shared_buffer other) noexcept -> shared_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+/*
+    Leaves buffer empty. A buffer without storage freezes to an empty shared_buffer without allocating.
+*/
+template <typename T, typename A>
+shared_buffer<T, A>::shared_buffer(buffer_type&& buffer)
+{
+    if (not buffer.data)
+    {
+        return;
+    }
+
+    block_allocator allocator{ buffer.allocator };
+    block = block_traits::allocate(allocator, 1);
+    std::construct_at(block, 1, buffer.allocator, buffer.data, buffer.size, buffer.capacity);
+    data = std::to_address(buffer.data);
+    size = buffer.size;
+
+    buffer.data = nullptr;
+    buffer.size = 0;
+    buffer.capacity = 0;
+};
+
+template <typename T, typename A>
+auto shared_buffer<T, A>::operator [](size_type index) const -> const value_type&
+{
+    check_index(index, size);
+
+    return data[index];
+};
+
+/*
+    The count elements starting at offset, sharing ownership of the whole storage.
+*/
+template <typename T, typename A>
+auto shared_buffer<T, A>::slice(size_type offset, size_type count) const& -> shared_buffer
+{
+    return shared_buffer{ *this }.slice(offset, count);
+};
+
+template <typename T, typename A>
+auto shared_buffer<T, A>::slice(size_type offset, size_type count) && -> shared_buffer
+{
+    contract;
+        pre(offset <= size);
+        pre(count <= size - offset);
+
+    shared_buffer result{ std::move(*this) };
+    result.data += offset;
+    result.size = count;
+    return result;
+};
+
+/*
+    As the only owner, the storage is handed over as it is, with the viewed elements moved to its front
+    and the rest destroyed. Otherwise the viewed elements are copied into a new buffer.
+    Leaves this empty either way.
+*/
+template <typename T, typename A>
+auto shared_buffer<T, A>::thaw() && -> buffer_type
+{
+    if (not block)
+    {
+        return buffer_type{};
+    }
+
+    // pairs with the release of the owners that have gone, whose reads must finish before the elements change.
+    if (block->references.load(std::memory_order_acquire) == 1)
+    {
+        const size_type offset = static_cast<size_type>(data - std::to_address(block->data));
+        const size_type count = size;
+        buffer_type buffer = take_block(std::exchange(block, nullptr));
+        data = nullptr;
+        size = 0;
+
+        if (offset > 0)
+        {
+            std::move(buffer.data + offset, buffer.data + offset + count, buffer.data);
+        }
+        buffer_type::destroy_elements(buffer.allocator, buffer.data + count, buffer.size - count);
+        buffer.size = count;
+        return buffer;
+    }
+
+    buffer_type buffer{ std::allocator_arg, traits::select_on_container_copy_construction(block->allocator) };
+    size_type capacity = size;
+    buffer.data = buffer_type::allocate_storage(buffer.allocator, capacity);
+    buffer.capacity = capacity;
+    buffer_type::copy_elements(buffer.allocator, buffer.data, data, size);
+    buffer.size = size;
+
+    release();
+    return buffer;
+};
+
+/*
+    Drops this owner's reference, destroying the elements if it was the last, and leaves this empty.
+*/
+template <typename T, typename A>
+auto shared_buffer<T, A>::release() noexcept -> void
+{
+    // the last owner to go must see every other owner's reads of the elements finished.
+    if (block and block->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        take_block(block);
+    }
+
+    data = nullptr;
+    size = 0;
+    block = nullptr;
+};
+
+template <typename T, typename A>
+auto shared_buffer<T, A>::use_count() const noexcept -> size_type
+{
+    return block ? block->references.load(std::memory_order_relaxed) : 0;
+};
+
+/*
+    Moves the storage out of a block no one else refers to into a dynamic_buffer, and frees the block.
+*/
+template <typename T, typename A>
+auto shared_buffer<T, A>::take_block(control_block* block) noexcept -> buffer_type
+{
+    buffer_type buffer{ std::allocator_arg, block->allocator };
+    buffer.data = block->data;
+    buffer.size = block->size;
+    buffer.capacity = block->capacity;
+
+    block_allocator allocator{ block->allocator };
+    std::destroy_at(block);
+    block_traits::deallocate(allocator, block, 1);
+    return buffer;
+};
+
+template <typename T, typename A>
+auto operator ==(const shared_buffer<T, A>& left, const shared_buffer<T, A>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    return equal_elements(left.data, right.data, left.size);
+};
+
+template <typename T, typename A>
+auto operator <=>(const shared_buffer<T, A>& left, const shared_buffer<T, A>& right) noexcept -> std::partial_ordering
+{
+    return compare_elements(left.data, left.size, right.data, right.size);
+};
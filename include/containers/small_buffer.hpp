@@ -0,0 +1,549 @@
+#pragma once
+
+#include <memory>
+#include <initializer_list>
+#include <compare>
+#include <utility>
+
+#include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A dynamic_buffer that keeps up to InlineN elements inside the object.
+    Only allocates once resized past InlineN, and returns to the inline storage when resized to zero
+    or shrunk to fit within it.
+    Moving a buffer that is still inline moves its elements, moving one on the heap only moves a pointer,
+    unless it is assigned to a buffer whose allocator cannot free that pointer.
+*/
+
+template <typename T, std::size_t InlineN, typename A = std::allocator<T>>
+struct small_buffer
+{
+    static_assert(InlineN > 0, "use dynamic_buffer when nothing is kept inline");
+
+    using traits = std::allocator_traits<A>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = typename traits::value_type;
+    using size_type = typename traits::size_type;
+    using pointer = typename traits::pointer;
+    using elements = dynamic_buffer<T, A>;
+
+    static constexpr size_type inline_capacity = InlineN;
+
+    size_type size = 0;
+    size_type capacity = InlineN;
+    [[no_unique_address]] allocator_type allocator = {};
+    pointer data = inline_data();
+    union
+    {
+        value_type storage[InlineN];
+    };
+
+    constexpr small_buffer() noexcept {};
+    constexpr small_buffer(const small_buffer& other);
+    constexpr small_buffer(small_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<value_type>);
+    constexpr ~small_buffer();
+    constexpr auto operator =(const small_buffer& other) -> small_buffer&;
+    constexpr auto operator =(small_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<value_type>
+        and (traits::propagate_on_container_move_assignment::value or traits::is_always_equal::value)) -> small_buffer&;
+
+    constexpr small_buffer(std::initializer_list<value_type> init);
+    template <typename... Args>
+    constexpr small_buffer(size_type size, Args&&... arguments);
+    constexpr small_buffer(uninitialized_t, size_type size);
+
+    constexpr explicit small_buffer(const allocator_type& allocator) noexcept;
+    constexpr small_buffer(std::allocator_arg_t, const allocator_type& allocator) noexcept;
+
+    constexpr auto operator [](size_type index)       & -> value_type&;
+    constexpr auto operator [](size_type index) const & -> const value_type&;
+    constexpr auto operator [](size_type index)      && -> value_type&&;
+
+    template <typename... Args>
+    constexpr auto resize(size_type size, Args&&... arguments) -> void;
+    constexpr auto resize(uninitialized_t, size_type size) -> void;
+    constexpr auto shrink_to_fit() -> void;
+
+    constexpr auto inline_data() noexcept -> pointer
+    {
+        return std::pointer_traits<pointer>::pointer_to(*storage);
+    };
+    constexpr auto is_inline() const noexcept -> bool
+    {
+        return std::to_address(data) == storage;
+    };
+
+    constexpr auto reserve_storage(size_type count) -> void;
+    constexpr auto move_storage(small_buffer& other) -> void;
+    constexpr auto release_storage() -> void;
+
+    using iterator = dynamic_buffer_iterator<T>;
+    using const_iterator = dynamic_buffer_const_iterator<T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr auto begin() noexcept -> iterator
+    {
+        return iterator{ std::to_address(data) };
+    };
+    constexpr auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) };
+    };
+    constexpr auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) };
+    };
+    constexpr auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    constexpr auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    constexpr auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    constexpr auto end() noexcept -> iterator
+    {
+        return iterator{ std::to_address(data) + size };
+    };
+    constexpr auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) + size };
+    };
+    constexpr auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) + size };
+    };
+    constexpr auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    constexpr auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    constexpr auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto swap(small_buffer<T, InlineN, A>& left, small_buffer<T, InlineN, A>& right)
+    noexcept(std::is_nothrow_move_assignable_v<small_buffer<T, InlineN, A>>) -> void
+{
+    using std::swap;
+
+    if (not left.is_inline() and not right.is_inline())
+    {
+        swap(left.size, right.size);
+        swap(left.capacity, right.capacity);
+        swap(left.data, right.data);
+
+        if constexpr (small_buffer<T, InlineN, A>::traits::propagate_on_container_swap::value)
+        {
+            swap(left.allocator, right.allocator);
+        }
+        return;
+    }
+
+    small_buffer<T, InlineN, A> temporary{ std::move(left) };
+    left = std::move(right);
+    right = std::move(temporary);
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(const small_buffer& other) :
+    allocator{ traits::select_on_container_copy_construction(other.allocator) }
+{
+    try
+    {
+        reserve_storage(other.size);
+        elements::copy_elements(allocator, data, std::to_address(other.data), other.size);
+    }
+    catch (...)
+    {
+        release_storage();
+        throw;
+    }
+    size = other.size;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(small_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<value_type>) :
+    allocator{ std::move(other.allocator) }
+{
+    move_storage(other);
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::~small_buffer()
+{
+    release_storage();
+    default_checking::check(size == 0);
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::operator =(const small_buffer& other) -> small_buffer&
+{
+    if (this == std::addressof(other))
+    {
+        return *this;
+    }
+
+    constexpr bool propagate = traits::propagate_on_container_copy_assignment::value;
+    small_buffer copy{ std::allocator_arg, propagate ? other.allocator : allocator };
+    copy.reserve_storage(other.size);
+    elements::copy_elements(copy.allocator, copy.data, std::to_address(other.data), other.size);
+    copy.size = other.size;
+
+    release_storage();
+    if constexpr (propagate)
+    {
+        allocator = other.allocator;
+    }
+    move_storage(copy);
+    return *this;
+};
+
+/*
+    Takes the heap block of other when the allocator propagates or the two allocators are equal,
+    otherwise moves the elements one by one into storage from this buffer's allocator.
+*/
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::operator =(small_buffer&& other) noexcept(std::is_nothrow_move_constructible_v<value_type>
+    and (traits::propagate_on_container_move_assignment::value or traits::is_always_equal::value)) -> small_buffer&
+{
+    if (this == std::addressof(other))
+    {
+        return *this;
+    }
+
+    if constexpr (traits::propagate_on_container_move_assignment::value)
+    {
+        release_storage();
+        allocator = std::move(other.allocator);
+        move_storage(other);
+    }
+    else
+    {
+        if (traits::is_always_equal::value or allocator == other.allocator)
+        {
+            release_storage();
+            move_storage(other);
+        }
+        else
+        {
+            small_buffer moved{ std::allocator_arg, allocator };
+            moved.reserve_storage(other.size);
+            elements::relocate_elements(moved.allocator, moved.data, other.data, other.size);
+            moved.size = std::exchange(other.size, 0);
+            other.release_storage();
+
+            release_storage();
+            move_storage(moved);
+        }
+    }
+
+    return *this;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(std::initializer_list<value_type> init)
+{
+    try
+    {
+        reserve_storage(init.size());
+        elements::copy_elements(allocator, data, init.begin(), init.size());
+    }
+    catch (...)
+    {
+        release_storage();
+        throw;
+    }
+    size = init.size();
+};
+
+template <typename T, std::size_t InlineN, typename A>
+template <typename... Args>
+constexpr small_buffer<T, InlineN, A>::small_buffer(size_type size, Args&&... arguments)
+{
+    try
+    {
+        reserve_storage(size);
+        elements::construct_elements(allocator, data, size, std::forward<Args>(arguments)...);
+    }
+    catch (...)
+    {
+        release_storage();
+        throw;
+    }
+    this->size = size;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(uninitialized_t, size_type size)
+{
+    reserve_storage(size);
+    this->size = size;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(const allocator_type& allocator) noexcept :
+    allocator{ allocator }
+{};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr small_buffer<T, InlineN, A>::small_buffer(std::allocator_arg_t, const allocator_type& allocator) noexcept :
+    allocator{ allocator }
+{};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::operator [](size_type index) & -> value_type&
+{
+    check_index(index, size);
+
+    return data[index];
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::operator [](size_type index) const& -> const value_type&
+{
+    check_index(index, size);
+
+    return data[index];
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::operator [](size_type index) && -> value_type&&
+{
+    check_index(index, size);
+
+    return std::move(data[index]);
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto operator ==(const small_buffer<T, InlineN, A>& left, const small_buffer<T, InlineN, A>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    return equal_elements(std::to_address(left.data), std::to_address(right.data), left.size);
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto operator <=>(const small_buffer<T, InlineN, A>& left, const small_buffer<T, InlineN, A>& right) noexcept -> std::partial_ordering
+{
+    return compare_elements(std::to_address(left.data), left.size, std::to_address(right.data), right.size);
+};
+
+/*
+    Same guarantees as dynamic_buffer::resize, sizes within the capacity are handled in place.
+*/
+template <typename T, std::size_t InlineN, typename A>
+template <typename... Args>
+constexpr auto small_buffer<T, InlineN, A>::resize(size_type new_size, Args&&... arguments) -> void
+{
+    if (size == new_size)
+    {
+        return;
+    }
+
+    if (new_size == 0)
+    {
+        release_storage();
+        return;
+    }
+
+    if (new_size < size)
+    {
+        elements::destroy_elements(allocator, data + new_size, size - new_size);
+        size = new_size;
+        return;
+    }
+
+    if (new_size <= capacity)
+    {
+        elements::construct_elements(allocator, data + size, new_size - size, std::forward<Args>(arguments)...);
+        size = new_size;
+        return;
+    }
+
+    // build the new elements before relocating the old ones, arguments may refer into the buffer.
+    size_type new_capacity = new_size;
+    pointer new_data = elements::allocate_storage(allocator, new_capacity);
+    try
+    {
+        elements::construct_elements(allocator, new_data + size, new_size - size, std::forward<Args>(arguments)...);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, new_data, new_capacity);
+        throw;
+    }
+    try
+    {
+        elements::relocate_elements(allocator, new_data, data, size);
+    }
+    catch (...)
+    {
+        elements::destroy_elements(allocator, new_data + size, new_size - size);
+        traits::deallocate(allocator, new_data, new_capacity);
+        throw;
+    }
+
+    if (not is_inline())
+    {
+        traits::deallocate(allocator, data, capacity);
+    }
+    size = new_size;
+    capacity = new_capacity;
+    data = new_data;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::resize(uninitialized_t, size_type new_size) -> void
+{
+    if (size == new_size)
+    {
+        return;
+    }
+
+    if (new_size == 0)
+    {
+        release_storage();
+        return;
+    }
+
+    if (new_size < size)
+    {
+        elements::destroy_elements(allocator, data + new_size, size - new_size);
+    }
+    else if (new_size > capacity)
+    {
+        reserve_storage(new_size);
+    }
+    size = new_size;
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::shrink_to_fit() -> void
+{
+    if (is_inline() or size == capacity)
+    {
+        return;
+    }
+
+    if (size == 0)
+    {
+        release_storage();
+        return;
+    }
+
+    size_type new_capacity = size;
+    pointer new_data = size <= InlineN ? inline_data() : elements::allocate_storage(allocator, new_capacity);
+    try
+    {
+        elements::relocate_elements(allocator, new_data, data, size);
+    }
+    catch (...)
+    {
+        if (new_data != inline_data())
+        {
+            traits::deallocate(allocator, new_data, new_capacity);
+        }
+        throw;
+    }
+
+    traits::deallocate(allocator, data, capacity);
+    capacity = size <= InlineN ? InlineN : new_capacity;
+    data = new_data;
+};
+
+/*
+    Moves the elements into storage for at least count elements, does nothing if they already fit.
+    Leaves the buffer untouched if this throws.
+*/
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::reserve_storage(size_type count) -> void
+{
+    if (count <= capacity)
+    {
+        return;
+    }
+
+    size_type new_capacity = count;
+    pointer new_data = elements::allocate_storage(allocator, new_capacity);
+    try
+    {
+        elements::relocate_elements(allocator, new_data, data, size);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, new_data, new_capacity);
+        throw;
+    }
+
+    if (not is_inline())
+    {
+        traits::deallocate(allocator, data, capacity);
+    }
+    capacity = new_capacity;
+    data = new_data;
+};
+
+/*
+    Takes the elements of other, which is left empty and inline. This buffer must be empty and inline,
+    and its allocator must be able to free the heap block of other.
+*/
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::move_storage(small_buffer& other) -> void
+{
+    contract;
+        pre(size == 0);
+        pre(is_inline());
+
+    if (other.is_inline())
+    {
+        elements::relocate_elements(allocator, data, other.data, other.size);
+        size = std::exchange(other.size, 0);
+        return;
+    }
+
+    size = std::exchange(other.size, 0);
+    capacity = std::exchange(other.capacity, InlineN);
+    data = std::exchange(other.data, other.inline_data());
+};
+
+template <typename T, std::size_t InlineN, typename A>
+constexpr auto small_buffer<T, InlineN, A>::release_storage() -> void
+{
+    elements::destroy_elements(allocator, data, size);
+    if (not is_inline())
+    {
+        traits::deallocate(allocator, data, capacity);
+    }
+    size = 0;
+    capacity = InlineN;
+    data = inline_data();
+};
+
+template <typename T, std::size_t InlineN, typename A = std::allocator<T>>
+using small_buffer_iterator = typename small_buffer<T, InlineN, A>::iterator;
+
+template <typename T, std::size_t InlineN, typename A = std::allocator<T>>
+using small_buffer_const_iterator = typename small_buffer<T, InlineN, A>::const_iterator;
+
+template <typename T, std::size_t InlineN, typename A = std::allocator<T>>
+using small_buffer_reverse_iterator = typename small_buffer<T, InlineN, A>::reverse_iterator;
+
+template <typename T, std::size_t InlineN, typename A = std::allocator<T>>
+using small_buffer_const_reverse_iterator = typename small_buffer<T, InlineN, A>::const_reverse_iterator;
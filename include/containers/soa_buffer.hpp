@@ -0,0 +1,591 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "checking.hpp"
+#include "aligned_allocator.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A buffer of rows stored as one contiguous column per field, structure of arrays style.
+    Can only change size when explicitly resized, like dynamic_buffer.
+
+    All columns share a single allocation, each starting on a column_alignment boundary, so a scan over
+    one field touches only that field's memory and vectorizes at full width.
+    Rows are read and written through soa_row, a tuple of references, the row iterators are random access.
+    The allocator is rebound to column_block, a column_alignment aligned run of bytes, so any allocator
+    that honours the alignment of its value type hands out storage the columns can assume is aligned.
+    Fields must be nothrow move constructible, so moving the columns into new storage cannot fail.
+    A moved from soa_buffer holds no rows and may only be assigned to or destroyed.
+*/
+
+/*
+    A row of an soa_buffer, a tuple of references into its columns.
+    Its own type rather than a plain std::tuple so it can declare a common reference with the row values,
+    which std::tuple of references only has where the library implements it.
+*/
+template <typename... Refs>
+struct soa_row : std::tuple<Refs...>
+{
+    using std::tuple<Refs...>::tuple;
+    using std::tuple<Refs...>::operator =;
+
+    // binds to the fields of a row value, which std::tuple of references only allows from C++23 libraries.
+    template <typename... Us>
+        requires (sizeof...(Us) == sizeof...(Refs) and (std::is_constructible_v<Refs, Us&> and ...))
+    constexpr soa_row(std::tuple<Us...>& values) :
+        std::tuple<Refs...>{ std::apply([](Us&... fields) { return std::tuple<Refs...>{ fields... }; }, values) }
+    {};
+};
+
+template <typename... Refs>
+struct std::tuple_size<soa_row<Refs...>> : std::integral_constant<std::size_t, sizeof...(Refs)> {};
+
+template <std::size_t I, typename... Refs>
+struct std::tuple_element<I, soa_row<Refs...>> : std::tuple_element<I, std::tuple<Refs...>> {};
+
+template <typename... Refs, typename... Us, template <typename> typename TQual, template <typename> typename UQual>
+    requires (sizeof...(Refs) == sizeof...(Us)) and requires { typename soa_row<std::common_reference_t<TQual<Refs>, UQual<Us>>...>; }
+struct std::basic_common_reference<soa_row<Refs...>, std::tuple<Us...>, TQual, UQual>
+{
+    using type = soa_row<std::common_reference_t<TQual<Refs>, UQual<Us>>...>;
+};
+
+template <typename... Us, typename... Refs, template <typename> typename TQual, template <typename> typename UQual>
+    requires (sizeof...(Refs) == sizeof...(Us)) and requires { typename soa_row<std::common_reference_t<TQual<Us>, UQual<Refs>>...>; }
+struct std::basic_common_reference<std::tuple<Us...>, soa_row<Refs...>, TQual, UQual>
+{
+    using type = soa_row<std::common_reference_t<TQual<Us>, UQual<Refs>>...>;
+};
+
+template <typename A, typename... Ts>
+struct basic_soa_buffer
+{
+    static_assert(sizeof...(Ts) > 0, "an soa_buffer needs at least one column");
+    static_assert((std::is_nothrow_move_constructible_v<Ts> and ...), "columns are relocated without a way back");
+
+    static constexpr std::size_t column_count = sizeof...(Ts);
+    static constexpr std::size_t column_alignment = std::max({ std::size_t{ 64 }, alignof(Ts)... });
+
+    struct alignas(column_alignment) column_block
+    {
+        std::byte bytes[column_alignment];
+    };
+
+    using traits = typename std::allocator_traits<A>::template rebind_traits<column_block>;
+    using allocator_type = typename traits::allocator_type;
+    using size_type = std::size_t;
+    using value_type = std::tuple<Ts...>;
+    using reference = soa_row<Ts&...>;
+    using const_reference = soa_row<const Ts&...>;
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+    template <std::size_t I>
+    using elements = dynamic_buffer<column_type<I>, typename traits::template rebind_alloc<column_type<I>>>;
+
+    static constexpr auto column_offsets(size_type capacity) noexcept -> std::array<std::size_t, column_count + 1>;
+
+    size_type size = 0;
+    size_type capacity = 0;
+    [[no_unique_address]] allocator_type allocator = {};
+    std::byte* data = nullptr;
+    std::tuple<Ts*...> columns = {};
+
+    basic_soa_buffer() = default;
+    basic_soa_buffer(const basic_soa_buffer& other);
+    basic_soa_buffer(basic_soa_buffer&& other) noexcept;
+    ~basic_soa_buffer();
+    auto operator =(basic_soa_buffer other) noexcept -> basic_soa_buffer&;
+
+    explicit basic_soa_buffer(const allocator_type& allocator);
+    explicit basic_soa_buffer(size_type size);
+    basic_soa_buffer(size_type size, const Ts&... values);
+    basic_soa_buffer(uninitialized_t, size_type size);
+
+    auto operator [](size_type index) noexcept -> reference;
+    auto operator [](size_type index) const noexcept -> const_reference;
+
+    template <std::size_t I>
+    auto column() noexcept -> std::span<column_type<I>>
+    {
+        return { std::assume_aligned<column_alignment>(std::get<I>(columns)), size };
+    };
+    template <std::size_t I>
+    auto column() const noexcept -> std::span<const column_type<I>>
+    {
+        return { std::assume_aligned<column_alignment>(std::get<I>(columns)), size };
+    };
+
+    auto resize(size_type size) -> void;
+    auto resize(size_type size, const Ts&... values) -> void;
+
+    template <typename... Args>
+    auto resize_rows(size_type size, const Args&... values) -> void;
+    template <typename... Args>
+    auto construct_rows(size_type first, size_type count, const Args&... values) -> void;
+    auto destroy_rows(size_type first, size_type count) noexcept -> void;
+    auto allocate_storage(size_type count) -> std::byte*;
+    auto point_columns(std::byte* storage, size_type count) noexcept -> std::tuple<Ts*...>;
+    auto release_storage() noexcept -> void;
+
+    template <bool Const>
+    struct row_iterator
+    {
+        using value_type = std::tuple<Ts...>;
+        using reference_type = std::conditional_t<Const, soa_row<const Ts&...>, soa_row<Ts&...>>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = reference_type;
+        using iterator_concept = std::random_access_iterator_tag;
+        // the rows are proxies, but the legacy algorithms still get random access, as with vector<bool>.
+        using iterator_category = std::random_access_iterator_tag;
+
+        std::tuple<std::conditional_t<Const, const Ts*, Ts*>...> columns = {};
+        difference_type index = 0;
+
+        constexpr auto operator ==(const row_iterator& other) const noexcept -> bool
+        {
+            return index == other.index;
+        };
+        constexpr auto operator <=>(const row_iterator& other) const noexcept -> std::strong_ordering
+        {
+            return index <=> other.index;
+        };
+
+        constexpr auto operator *() const -> reference_type
+        {
+            return std::apply([this](auto*... column) { return reference_type{ column[index]... }; }, columns);
+        };
+        constexpr auto operator [](difference_type offset) const -> reference_type
+        {
+            return *(*this + offset);
+        };
+
+        constexpr auto operator ++() -> row_iterator&
+        {
+            ++index;
+            return *this;
+        };
+        constexpr auto operator ++(int) -> row_iterator
+        {
+            row_iterator old = *this;
+            ++index;
+            return old;
+        };
+        constexpr auto operator --() -> row_iterator&
+        {
+            --index;
+            return *this;
+        };
+        constexpr auto operator --(int) -> row_iterator
+        {
+            row_iterator old = *this;
+            --index;
+            return old;
+        };
+        constexpr auto operator +=(difference_type offset) -> row_iterator&
+        {
+            index += offset;
+            return *this;
+        };
+        constexpr auto operator -=(difference_type offset) -> row_iterator&
+        {
+            index -= offset;
+            return *this;
+        };
+        constexpr auto operator +(difference_type offset) const -> row_iterator
+        {
+            return { columns, index + offset };
+        };
+        constexpr friend auto operator +(difference_type offset, const row_iterator& iter) -> row_iterator
+        {
+            return iter + offset;
+        };
+        constexpr auto operator -(difference_type offset) const -> row_iterator
+        {
+            return { columns, index - offset };
+        };
+        constexpr auto operator -(const row_iterator& other) const -> difference_type
+        {
+            return index - other.index;
+        };
+    };
+
+    using iterator = row_iterator<false>;
+    using const_iterator = row_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    auto begin() noexcept -> iterator
+    {
+        return iterator{ columns, 0 };
+    };
+    auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ columns, 0 };
+    };
+    auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ columns, 0 };
+    };
+    auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    auto end() noexcept -> iterator
+    {
+        return iterator{ columns, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ columns, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ columns, static_cast<std::ptrdiff_t>(size) };
+    };
+    auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename... Ts>
+using soa_buffer = basic_soa_buffer<aligned_allocator<std::byte, 64>, Ts...>;
+
+template <typename A, typename... Ts>
+auto swap(basic_soa_buffer<A, Ts...>& left, basic_soa_buffer<A, Ts...>& right) noexcept -> void
+{
+    using std::swap;
+
+    swap(left.size, right.size);
+    swap(left.capacity, right.capacity);
+    swap(left.data, right.data);
+    swap(left.columns, right.columns);
+
+    if constexpr (basic_soa_buffer<A, Ts...>::traits::propagate_on_container_swap::value)
+    {
+        swap(left.allocator, right.allocator);
+    }
+};
+
+/*
+    Byte offsets of every column for a given capacity, followed by the size of the whole allocation.
+*/
+template <typename A, typename... Ts>
+constexpr auto basic_soa_buffer<A, Ts...>::column_offsets(size_type capacity) noexcept -> std::array<std::size_t, column_count + 1>
+{
+    constexpr std::size_t sizes[] = { sizeof(Ts)... };
+    std::array<std::size_t, column_count + 1> offsets{};
+    for (std::size_t i = 0; i < column_count; ++i)
+    {
+        offsets[i + 1] = (offsets[i] + sizes[i] * capacity + column_alignment - 1) / column_alignment * column_alignment;
+    }
+    return offsets;
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::allocate_storage(size_type count) -> std::byte*
+{
+    if (count == 0)
+    {
+        return nullptr;
+    }
+    if (count > (std::numeric_limits<std::size_t>::max() / 2) / (sizeof(Ts) + ...))
+    {
+        throw std::bad_array_new_length{};
+    }
+
+    return reinterpret_cast<std::byte*>(traits::allocate(allocator, column_offsets(count)[column_count] / column_alignment));
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::point_columns(std::byte* storage, size_type count) noexcept -> std::tuple<Ts*...>
+{
+    if (not storage)
+    {
+        return {};
+    }
+
+    const auto offsets = column_offsets(count);
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        return std::tuple<Ts*...>{ reinterpret_cast<Ts*>(storage + offsets[Is])... };
+    }(std::index_sequence_for<Ts...>{});
+};
+
+/*
+    Constructs rows [first, first + count) column by column, from values when given.
+    If a column throws, the columns already built are destroyed again.
+*/
+template <typename A, typename... Ts>
+template <typename... Args>
+auto basic_soa_buffer<A, Ts...>::construct_rows(size_type first, size_type count, const Args&... values) -> void
+{
+    [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        std::size_t built = 0;
+        try
+        {
+            ([&]
+            {
+                typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+                if constexpr (sizeof...(Args) == 0)
+                {
+                    elements<Is>::construct_elements(column_allocator, std::get<Is>(columns) + first, count);
+                }
+                else
+                {
+                    elements<Is>::construct_elements(column_allocator, std::get<Is>(columns) + first, count, std::get<Is>(std::tie(values...)));
+                }
+                ++built;
+            }(), ...);
+        }
+        catch (...)
+        {
+            ([&]
+            {
+                if (Is < built)
+                {
+                    typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+                    elements<Is>::destroy_elements(column_allocator, std::get<Is>(columns) + first, count);
+                }
+            }(), ...);
+            throw;
+        }
+    }(std::index_sequence_for<Ts...>{});
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::destroy_rows(size_type first, size_type count) noexcept -> void
+{
+    [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        ([&]
+        {
+            typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+            elements<Is>::destroy_elements(column_allocator, std::get<Is>(columns) + first, count);
+        }(), ...);
+    }(std::index_sequence_for<Ts...>{});
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::release_storage() noexcept -> void
+{
+    destroy_rows(0, size);
+    if (data)
+    {
+        traits::deallocate(allocator, reinterpret_cast<column_block*>(data), column_offsets(capacity)[column_count] / column_alignment);
+    }
+    size = 0;
+    capacity = 0;
+    data = nullptr;
+    columns = {};
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(const basic_soa_buffer& other) :
+    basic_soa_buffer{ traits::select_on_container_copy_construction(other.allocator) }
+{
+    capacity = other.size;
+    data = allocate_storage(capacity);
+    columns = point_columns(data, capacity);
+
+    [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        std::size_t copied = 0;
+        try
+        {
+            ([&]
+            {
+                typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+                elements<Is>::copy_elements(column_allocator, std::get<Is>(columns), std::get<Is>(other.columns), other.size);
+                ++copied;
+            }(), ...);
+        }
+        catch (...)
+        {
+            ([&]
+            {
+                if (Is < copied)
+                {
+                    typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+                    elements<Is>::destroy_elements(column_allocator, std::get<Is>(columns), other.size);
+                }
+            }(), ...);
+            throw;
+        }
+    }(std::index_sequence_for<Ts...>{});
+    size = other.size;
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(basic_soa_buffer&& other) noexcept :
+    basic_soa_buffer{}
+{
+    swap(*this, other);
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::~basic_soa_buffer()
+{
+    release_storage();
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::operator =(basic_soa_buffer other) noexcept -> basic_soa_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(const allocator_type& allocator) :
+    allocator{ allocator }
+{};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(size_type size) :
+    basic_soa_buffer{ uninitialized, size }
+{
+    const size_type count = std::exchange(this->size, 0);
+    construct_rows(0, count);
+    this->size = count;
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(size_type size, const Ts&... values) :
+    basic_soa_buffer{ uninitialized, size }
+{
+    const size_type count = std::exchange(this->size, 0);
+    construct_rows(0, count, values...);
+    this->size = count;
+};
+
+template <typename A, typename... Ts>
+basic_soa_buffer<A, Ts...>::basic_soa_buffer(uninitialized_t, size_type size) :
+    size{ size },
+    capacity{ size }
+{
+    data = allocate_storage(capacity);
+    columns = point_columns(data, capacity);
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::operator [](size_type index) noexcept -> reference
+{
+    check_index(index, size);
+
+    return std::apply([index](Ts*... column) { return reference{ column[index]... }; }, columns);
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::operator [](size_type index) const noexcept -> const_reference
+{
+    check_index(index, size);
+
+    return std::apply([index](const Ts*... column) { return const_reference{ column[index]... }; }, columns);
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::resize(size_type new_size) -> void
+{
+    resize_rows(new_size);
+};
+
+template <typename A, typename... Ts>
+auto basic_soa_buffer<A, Ts...>::resize(size_type new_size, const Ts&... values) -> void
+{
+    resize_rows(new_size, values...);
+};
+
+/*
+    Resizes every column at once, with the strong exception guarantee, new rows are copies of values
+    or value initialized without them.
+    Sizes within the capacity are handled in place, shrinking never releases memory.
+*/
+template <typename A, typename... Ts>
+template <typename... Args>
+auto basic_soa_buffer<A, Ts...>::resize_rows(size_type new_size, const Args&... values) -> void
+{
+    if (new_size <= size)
+    {
+        destroy_rows(new_size, size - new_size);
+        size = new_size;
+        return;
+    }
+
+    if (new_size <= capacity)
+    {
+        construct_rows(size, new_size - size, values...);
+        size = new_size;
+        return;
+    }
+
+    basic_soa_buffer grown{ allocator };
+    grown.capacity = new_size;
+    grown.data = grown.allocate_storage(new_size);
+    grown.columns = grown.point_columns(grown.data, new_size);
+    grown.construct_rows(size, new_size - size, values...);
+
+    // cannot throw, every column moves without throwing.
+    [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        ([&]
+        {
+            typename traits::template rebind_alloc<column_type<Is>> column_allocator{ allocator };
+            elements<Is>::relocate_elements(column_allocator, std::get<Is>(grown.columns), std::get<Is>(columns), size);
+        }(), ...);
+    }(std::index_sequence_for<Ts...>{});
+
+    grown.size = new_size;
+    size = 0;
+    swap(*this, grown);
+};
+
+template <typename A, typename... Ts>
+auto operator ==(const basic_soa_buffer<A, Ts...>& left, const basic_soa_buffer<A, Ts...>& right) noexcept -> bool
+{
+    if (left.size != right.size)
+    {
+        return false;
+    }
+
+    return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+    {
+        return (equal_elements(std::get<Is>(left.columns), std::get<Is>(right.columns), left.size) and ...);
+    }(std::index_sequence_for<Ts...>{});
+};
+
+template <typename A, typename... Ts>
+using soa_buffer_iterator = typename basic_soa_buffer<A, Ts...>::iterator;
+
+template <typename A, typename... Ts>
+using soa_buffer_const_iterator = typename basic_soa_buffer<A, Ts...>::const_iterator;
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <utility>
+
+#include "contract.hpp"
+#include "dynamic_buffer.hpp"
+
+/*
+    A bounded lock free queue for exactly one producer thread and one consumer thread.
+
+    The capacity is rounded up to a power of two so indices wrap with a mask. Each side owns one cache
+    line holding its index and a cached copy of the other side's. Single element operations only reload
+    the other index when the cached copy says the ring is full or empty, batches reload it once each.
+    writable() and readable() hand out the contiguous run of free or filled slots for zero copy batches,
+    free slots are uninitialized and must be constructed, e.g. with std::construct_at, before commit_write.
+*/
+
+template <typename T, typename A = std::allocator<T>>
+struct spsc_ring
+{
+    using traits = std::allocator_traits<A>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = typename traits::value_type;
+    using size_type = typename traits::size_type;
+    using pointer = typename traits::pointer;
+    using elements = dynamic_buffer<T, A>;
+
+    static constexpr std::size_t cache_line = 64;
+
+    [[no_unique_address]] allocator_type allocator = {};
+    size_type capacity = 0;
+    pointer data = nullptr;
+
+    alignas(cache_line) std::atomic<size_type> tail = 0;
+    size_type cached_head = 0;
+
+    alignas(cache_line) std::atomic<size_type> head = 0;
+    size_type cached_tail = 0;
+
+    explicit spsc_ring(size_type capacity);
+    spsc_ring(std::allocator_arg_t, const allocator_type& allocator, size_type capacity);
+    spsc_ring(const spsc_ring&) = delete;
+    ~spsc_ring();
+    auto operator =(const spsc_ring&) -> spsc_ring& = delete;
+
+    // producer side.
+    template <typename... Args>
+    auto try_push(Args&&... arguments) -> bool;
+    auto push(std::span<const value_type> values) -> size_type;
+    auto writable() noexcept -> std::span<value_type>;
+    auto commit_write(size_type count) noexcept -> void;
+
+    // consumer side.
+    auto try_pop(value_type& value) -> bool;
+    auto pop(std::span<value_type> values) -> size_type;
+    auto readable() noexcept -> std::span<value_type>;
+    auto commit_read(size_type count) noexcept -> void;
+
+    // exact only when neither side is running.
+    auto size() const noexcept -> size_type
+    {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    };
+    auto empty() const noexcept -> bool
+    {
+        return size() == 0;
+    };
+};
+
+template <typename T, typename A>
+spsc_ring<T, A>::spsc_ring(size_type capacity) :
+    spsc_ring{ std::allocator_arg, allocator_type{}, capacity }
+{};
+
+template <typename T, typename A>
+spsc_ring<T, A>::spsc_ring(std::allocator_arg_t, const allocator_type& allocator, size_type capacity) :
+    allocator{ allocator },
+    capacity{ std::bit_ceil(std::max<size_type>(capacity, 1)) }
+{
+    // take the capacity the allocator reports only while it is still a power of two.
+    size_type received = this->capacity;
+    data = elements::allocate_storage(this->allocator, received);
+    if (std::has_single_bit(received))
+    {
+        this->capacity = received;
+    }
+};
+
+template <typename T, typename A>
+spsc_ring<T, A>::~spsc_ring()
+{
+    for (size_type index = head.load(std::memory_order_relaxed); index != tail.load(std::memory_order_relaxed); ++index)
+    {
+        traits::destroy(allocator, data + (index & (capacity - 1)));
+    }
+    elements::deallocate_storage(allocator, data, capacity);
+};
+
+template <typename T, typename A>
+template <typename... Args>
+auto spsc_ring<T, A>::try_push(Args&&... arguments) -> bool
+{
+    const size_type index = tail.load(std::memory_order_relaxed);
+    if (index - cached_head == capacity)
+    {
+        cached_head = head.load(std::memory_order_acquire);
+        if (index - cached_head == capacity)
+        {
+            return false;
+        }
+    }
+
+    traits::construct(allocator, data + (index & (capacity - 1)), std::forward<Args>(arguments)...);
+    tail.store(index + 1, std::memory_order_release);
+    return true;
+};
+
+/*
+    The free slots from the tail up to the end of the storage or the head, whichever comes first.
+    Empty only when the ring is full.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::writable() noexcept -> std::span<value_type>
+{
+    const size_type index = tail.load(std::memory_order_relaxed);
+    cached_head = head.load(std::memory_order_acquire);
+
+    const size_type offset = index & (capacity - 1);
+    const size_type count = std::min(capacity - (index - cached_head), capacity - offset);
+    return { std::to_address(data) + offset, count };
+};
+
+/*
+    Publishes the first count slots of the last writable() span, which must all be constructed.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::commit_write(size_type count) noexcept -> void
+{
+    contract;
+        pre(count <= capacity - (tail.load(std::memory_order_relaxed) - cached_head));
+
+    tail.store(tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+};
+
+/*
+    Copies as many values as fit, returning how many that was.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::push(std::span<const value_type> values) -> size_type
+{
+    size_type pushed = 0;
+    for (int run = 0; run < 2 and pushed < values.size(); ++run)
+    {
+        const std::span<value_type> slots = writable();
+        const size_type count = std::min(slots.size(), values.size() - pushed);
+        elements::copy_elements(allocator, slots.data(), values.data() + pushed, count);
+        commit_write(count);
+        pushed += count;
+    }
+    return pushed;
+};
+
+template <typename T, typename A>
+auto spsc_ring<T, A>::try_pop(value_type& value) -> bool
+{
+    const size_type index = head.load(std::memory_order_relaxed);
+    if (index == cached_tail)
+    {
+        cached_tail = tail.load(std::memory_order_acquire);
+        if (index == cached_tail)
+        {
+            return false;
+        }
+    }
+
+    pointer slot = data + (index & (capacity - 1));
+    value = std::move(*slot);
+    traits::destroy(allocator, slot);
+    head.store(index + 1, std::memory_order_release);
+    return true;
+};
+
+/*
+    The filled slots from the head up to the end of the storage or the tail, whichever comes first.
+    Empty only when the ring is empty.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::readable() noexcept -> std::span<value_type>
+{
+    const size_type index = head.load(std::memory_order_relaxed);
+    cached_tail = tail.load(std::memory_order_acquire);
+
+    const size_type offset = index & (capacity - 1);
+    const size_type count = std::min(cached_tail - index, capacity - offset);
+    return { std::to_address(data) + offset, count };
+};
+
+/*
+    Destroys the first count slots of the last readable() span and hands them back to the producer.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::commit_read(size_type count) noexcept -> void
+{
+    contract;
+        pre(count <= cached_tail - head.load(std::memory_order_relaxed));
+
+    const size_type index = head.load(std::memory_order_relaxed);
+    elements::destroy_elements(allocator, data + (index & (capacity - 1)), count);
+    head.store(index + count, std::memory_order_release);
+};
+
+/*
+    Moves out as many values as are ready and fit, returning how many that was.
+*/
+template <typename T, typename A>
+auto spsc_ring<T, A>::pop(std::span<value_type> values) -> size_type
+{
+    size_type popped = 0;
+    for (int run = 0; run < 2 and popped < values.size(); ++run)
+    {
+        const std::span<value_type> slots = readable();
+        const size_type count = std::min(slots.size(), values.size() - popped);
+        std::move(slots.begin(), slots.begin() + count, values.begin() + popped);
+        commit_read(count);
+        popped += count;
+    }
+    return popped;
+};
@@ -3,16 +3,495 @@
 #include <memory>
 #include <initializer_list>
 #include <compare>
+#include <utility>
 
 #include "contract.hpp"
+#include "checking.hpp"
+#include "dynamic_buffer.hpp"
 
 /*
     A buffer whose length is decided at compile time.
-    Cannot be resized. 
+    Cannot be resized.
+
+    The length is part of the type rather than stored, so loops over it have a constant trip count
+    and get<index>() is checked at compile time.
+    Elements live on the heap by default, using inline_storage as the allocator keeps them inside the object.
+    A moved from heap allocated static_buffer holds no elements and may only be assigned to or destroyed.
 */
 
+struct inline_storage
+{
+    explicit inline_storage() = default;
+};
+
 template <typename T, std::size_t N, typename A = std::allocator<T>>
 struct static_buffer
 {
+    static_assert(N > 0, "a static_buffer must hold at least one element");
+
+    using traits = std::allocator_traits<A>;
+    using allocator_type = typename traits::allocator_type;
+    using value_type = typename traits::value_type;
+    using size_type = typename traits::size_type;
+    using pointer = typename traits::pointer;
+    using elements = dynamic_buffer<T, A>;
+
+    static constexpr size_type size = N;
+    [[no_unique_address]] allocator_type allocator = {};
+    pointer data = nullptr;
+
+    constexpr static_buffer();
+    constexpr static_buffer(const static_buffer& other);
+    constexpr static_buffer(static_buffer&& other) noexcept;
+    constexpr ~static_buffer();
+    constexpr auto operator =(static_buffer other) noexcept -> static_buffer&;
+
+    constexpr static_buffer(std::initializer_list<value_type> init);
+    template <typename... Args>
+        requires (sizeof...(Args) > 0 and std::constructible_from<T, Args&&...>)
+    constexpr explicit static_buffer(Args&&... arguments);
+    constexpr static_buffer(uninitialized_t);
+    constexpr explicit static_buffer(pointer data);
+
+    constexpr auto operator [](size_type index)       & -> value_type&;
+    constexpr auto operator [](size_type index) const & -> const value_type&;
+    constexpr auto operator [](size_type index)      && -> value_type&&;
+
+    template <size_type I>
+    constexpr auto get() & noexcept -> value_type&
+    {
+        static_assert(I < N);
+        return data[I];
+    };
+    template <size_type I>
+    constexpr auto get() const & noexcept -> const value_type&
+    {
+        static_assert(I < N);
+        return data[I];
+    };
+
+    using iterator = dynamic_buffer_iterator<T>;
+    using const_iterator = dynamic_buffer_const_iterator<T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr auto begin() noexcept -> iterator
+    {
+        return iterator{ std::to_address(data) };
+    };
+    constexpr auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) };
+    };
+    constexpr auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) };
+    };
+    constexpr auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    constexpr auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    constexpr auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    constexpr auto end() noexcept -> iterator
+    {
+        return iterator{ std::to_address(data) + N };
+    };
+    constexpr auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) + N };
+    };
+    constexpr auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ std::to_address(data) + N };
+    };
+    constexpr auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    constexpr auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    constexpr auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+/*
+    Keeps its elements inside the object, costing neither an allocation nor a size field.
+*/
+template <typename T, std::size_t N>
+struct static_buffer<T, N, inline_storage>
+{
+    static_assert(N > 0, "a static_buffer must hold at least one element");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using pointer = value_type*;
+
+    static constexpr size_type size = N;
+    value_type data[N];
+
+    constexpr static_buffer() : data{} {};
+    constexpr static_buffer(const static_buffer& other) = default;
+    constexpr static_buffer(static_buffer&& other) = default;
+    constexpr ~static_buffer() = default;
+    constexpr auto operator =(const static_buffer& other) -> static_buffer& = default;
+    constexpr auto operator =(static_buffer&& other) -> static_buffer& = default;
+
+    constexpr static_buffer(std::initializer_list<value_type> init);
+    template <typename... Args>
+        requires (sizeof...(Args) > 0 and std::constructible_from<T, Args&&...>
+            and (N == 1 or std::constructible_from<T, const std::remove_reference_t<Args>&...>))
+    constexpr explicit static_buffer(Args&&... arguments);
+    constexpr static_buffer(uninitialized_t) {};
+
+    // construct every element in place, so T needs neither a default constructor nor assignment.
+    template <std::size_t... I>
+    constexpr explicit static_buffer(std::index_sequence<I...>, const value_type* first);
+    template <std::size_t... I, typename... Args>
+    constexpr explicit static_buffer(std::index_sequence<I...>, std::in_place_t, Args&&... arguments);
+
+    static constexpr auto checked_elements(std::initializer_list<value_type> init) -> const value_type*;
+
+    // every element but the last is built from the arguments as const lvalues, only the last may move from them.
+    template <std::size_t I, typename... Args>
+    static constexpr auto make_element(Args&&... arguments) -> value_type;
+
+    constexpr auto operator [](size_type index)       & -> value_type&;
+    constexpr auto operator [](size_type index) const & -> const value_type&;
+    constexpr auto operator [](size_type index)      && -> value_type&&;
+
+    template <size_type I>
+    constexpr auto get() & noexcept -> value_type&
+    {
+        static_assert(I < N);
+        return data[I];
+    };
+    template <size_type I>
+    constexpr auto get() const & noexcept -> const value_type&
+    {
+        static_assert(I < N);
+        return data[I];
+    };
+
+    using iterator = dynamic_buffer_iterator<T>;
+    using const_iterator = dynamic_buffer_const_iterator<T>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    constexpr auto begin() noexcept -> iterator
+    {
+        return iterator{ data };
+    };
+    constexpr auto begin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    constexpr auto cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator{ data };
+    };
+    constexpr auto rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ end() };
+    };
+    constexpr auto rbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+    constexpr auto crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cend() };
+    };
+
+    constexpr auto end() noexcept -> iterator
+    {
+        return iterator{ data + N };
+    };
+    constexpr auto end() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + N };
+    };
+    constexpr auto cend() const noexcept -> const_iterator
+    {
+        return const_iterator{ data + N };
+    };
+    constexpr auto rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator{ begin() };
+    };
+    constexpr auto rend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ begin() };
+    };
+    constexpr auto crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator{ cbegin() };
+    };
+};
+
+template <typename T, std::size_t N>
+using inline_buffer = static_buffer<T, N, inline_storage>;
+
+template <typename T, std::size_t N, typename A>
+constexpr auto swap(static_buffer<T, N, A>& left, static_buffer<T, N, A>& right) noexcept -> void
+{
+    using std::swap;
+
+    swap(left.data, right.data);
+
+    if constexpr (static_buffer<T, N, A>::traits::propagate_on_container_swap::value)
+    {
+        swap(left.allocator, right.allocator);
+    }
+};
+
+template <typename T, std::size_t N>
+constexpr auto swap(static_buffer<T, N, inline_storage>& left, static_buffer<T, N, inline_storage>& right) noexcept(std::is_nothrow_swappable_v<T>) -> void
+{
+    using std::swap;
 
-};
\ No newline at end of file
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        swap(left.data[i], right.data[i]);
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer() :
+    allocator{},
+    data{ traits::allocate(allocator, N) }
+{
+    try
+    {
+        elements::construct_elements(allocator, data, N);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, data, N);
+        throw;
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer(const static_buffer& other) :
+    allocator{ traits::select_on_container_copy_construction(other.allocator) },
+    data{ traits::allocate(allocator, N) }
+{
+    try
+    {
+        elements::copy_elements(allocator, data, std::to_address(other.data), N);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, data, N);
+        throw;
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer(static_buffer&& other) noexcept :
+    allocator{ std::move(other.allocator) },
+    data{ std::exchange(other.data, nullptr) }
+{};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::~static_buffer()
+{
+    if (data)
+    {
+        elements::destroy_elements(allocator, data, N);
+        traits::deallocate(allocator, data, N);
+        data = nullptr;
+    }
+    default_checking::check(data == nullptr);
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto static_buffer<T, N, A>::operator =(static_buffer other) noexcept -> static_buffer&
+{
+    swap(*this, other);
+    return *this;
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer(std::initializer_list<value_type> init) :
+    allocator{},
+    data{ traits::allocate(allocator, N) }
+{
+    contract;
+        pre(init.size() == N);
+
+    try
+    {
+        elements::copy_elements(allocator, data, init.begin(), N);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, data, N);
+        throw;
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+template <typename... Args>
+    requires (sizeof...(Args) > 0 and std::constructible_from<T, Args&&...>)
+constexpr static_buffer<T, N, A>::static_buffer(Args&&... arguments) :
+    allocator{},
+    data{ traits::allocate(allocator, N) }
+{
+    try
+    {
+        elements::construct_elements(allocator, data, N, std::forward<Args>(arguments)...);
+    }
+    catch (...)
+    {
+        traits::deallocate(allocator, data, N);
+        throw;
+    }
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer(uninitialized_t) :
+    allocator{},
+    data{ traits::allocate(allocator, N) }
+{};
+
+template <typename T, std::size_t N, typename A>
+constexpr static_buffer<T, N, A>::static_buffer(pointer data) :
+    allocator{},
+    data{ data }
+{
+    contract;
+        pre(data != nullptr);
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto static_buffer<T, N, A>::operator [](size_type index) & -> value_type&
+{
+    check_index(index, N);
+
+    return data[index];
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto static_buffer<T, N, A>::operator [](size_type index) const& -> const value_type&
+{
+    check_index(index, N);
+
+    return data[index];
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto static_buffer<T, N, A>::operator [](size_type index) && -> value_type&&
+{
+    check_index(index, N);
+
+    return std::move(data[index]);
+};
+
+template <typename T, std::size_t N>
+constexpr static_buffer<T, N, inline_storage>::static_buffer(std::initializer_list<value_type> init) :
+    static_buffer(std::make_index_sequence<N>{}, checked_elements(init))
+{};
+
+template <typename T, std::size_t N>
+template <typename... Args>
+    requires (sizeof...(Args) > 0 and std::constructible_from<T, Args&&...>
+        and (N == 1 or std::constructible_from<T, const std::remove_reference_t<Args>&...>))
+constexpr static_buffer<T, N, inline_storage>::static_buffer(Args&&... arguments) :
+    static_buffer(std::make_index_sequence<N>{}, std::in_place, std::forward<Args>(arguments)...)
+{};
+
+template <typename T, std::size_t N>
+template <std::size_t... I>
+constexpr static_buffer<T, N, inline_storage>::static_buffer(std::index_sequence<I...>, const value_type* first) :
+    data{ first[I]... }
+{};
+
+template <typename T, std::size_t N>
+template <std::size_t... I, typename... Args>
+constexpr static_buffer<T, N, inline_storage>::static_buffer(std::index_sequence<I...>, std::in_place_t, Args&&... arguments) :
+    data{ make_element<I>(std::forward<Args>(arguments)...)... }
+{};
+
+template <typename T, std::size_t N>
+constexpr auto static_buffer<T, N, inline_storage>::checked_elements(std::initializer_list<value_type> init) -> const value_type*
+{
+    contract;
+        pre(init.size() == N);
+
+    return init.begin();
+};
+
+template <typename T, std::size_t N>
+template <std::size_t I, typename... Args>
+constexpr auto static_buffer<T, N, inline_storage>::make_element(Args&&... arguments) -> value_type
+{
+    if constexpr (I + 1 == N)
+    {
+        return value_type(std::forward<Args>(arguments)...);
+    }
+    else
+    {
+        return value_type(std::as_const(arguments)...);
+    }
+};
+
+template <typename T, std::size_t N>
+constexpr auto static_buffer<T, N, inline_storage>::operator [](size_type index) & -> value_type&
+{
+    check_index(index, N);
+
+    return data[index];
+};
+
+template <typename T, std::size_t N>
+constexpr auto static_buffer<T, N, inline_storage>::operator [](size_type index) const& -> const value_type&
+{
+    check_index(index, N);
+
+    return data[index];
+};
+
+template <typename T, std::size_t N>
+constexpr auto static_buffer<T, N, inline_storage>::operator [](size_type index) && -> value_type&&
+{
+    check_index(index, N);
+
+    return std::move(data[index]);
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto operator ==(const static_buffer<T, N, A>& left, const static_buffer<T, N, A>& right) noexcept -> bool
+{
+    return equal_elements(std::to_address(left.data), std::to_address(right.data), N);
+};
+
+template <typename T, std::size_t N, typename A>
+constexpr auto operator <=>(const static_buffer<T, N, A>& left, const static_buffer<T, N, A>& right) noexcept -> std::partial_ordering
+{
+    return compare_elements(std::to_address(left.data), N, std::to_address(right.data), N);
+};
+
+template <typename T, std::size_t N, typename A = std::allocator<T>>
+using static_buffer_iterator = typename static_buffer<T, N, A>::iterator;
+
+template <typename T, std::size_t N, typename A = std::allocator<T>>
+using static_buffer_const_iterator = typename static_buffer<T, N, A>::const_iterator;
+
+template <typename T, std::size_t N, typename A = std::allocator<T>>
+using static_buffer_reverse_iterator = typename static_buffer<T, N, A>::reverse_iterator;
+
+template <typename T, std::size_t N, typename A = std::allocator<T>>
+using static_buffer_const_reverse_iterator = typename static_buffer<T, N, A>::const_reverse_iterator;
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if __has_include(<mdspan>)
+#include <mdspan>
+#endif
+
+#ifndef CONTAINERS_HAS_MDSPAN
+#if defined(__cpp_lib_mdspan)
+#define CONTAINERS_HAS_MDSPAN 1
+#else
+#define CONTAINERS_HAS_MDSPAN 0
+#endif
+#endif
+
+#if CONTAINERS_HAS_MDSPAN
+
+/*
+    Layout policies for two dimensional std::mdspan, keeping elements that are close in both directions
+    close in memory as well.
+
+    layout_tiled stores the matrix as TileRows x TileColumns tiles in row major order, with each tile
+    row major inside. A stencil or transpose that walks one tile at a time then stays within a few
+    cache lines instead of striding across whole rows.
+    layout_morton stores it in Z-order, interleaving the bits of the row and column, which gives
+    every power of two block size locality at once without choosing a tile size.
+
+    Both pad the extents up to whole tiles, so their storage may be larger than rows * columns,
+    as given by required_span_size. Neither is strided.
+    Needs a standard library with std::mdspan, such as libstdc++ from GCC 15, and is empty otherwise.
+*/
+
+template <std::size_t TileRows, std::size_t TileColumns = TileRows>
+struct layout_tiled
+{
+    static_assert(TileRows > 0 and TileColumns > 0, "tiles must hold at least one element");
+
+    template <typename Extents>
+    struct mapping
+    {
+        static_assert(Extents::rank() == 2, "layout_tiled only maps matrices");
+
+        using extents_type = Extents;
+        using index_type = typename extents_type::index_type;
+        using size_type = typename extents_type::size_type;
+        using rank_type = typename extents_type::rank_type;
+        using layout_type = layout_tiled;
+
+        static constexpr index_type tile_rows = TileRows;
+        static constexpr index_type tile_columns = TileColumns;
+        static constexpr index_type tile_size = tile_rows * tile_columns;
+
+        extents_type bounds = {};
+        index_type tiles_per_row = 0;
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& bounds) noexcept :
+            bounds{ bounds },
+            tiles_per_row{ (bounds.extent(1) + tile_columns - 1) / tile_columns }
+        {};
+
+        constexpr auto extents() const noexcept -> const extents_type&
+        {
+            return bounds;
+        };
+        constexpr auto required_span_size() const noexcept -> index_type
+        {
+            return (bounds.extent(0) + tile_rows - 1) / tile_rows * tiles_per_row * tile_size;
+        };
+
+        constexpr auto operator ()(index_type row, index_type column) const noexcept -> index_type
+        {
+            const index_type tile = row / tile_rows * tiles_per_row + column / tile_columns;
+            return tile * tile_size + row % tile_rows * tile_columns + column % tile_columns;
+        };
+
+        static constexpr auto is_always_unique() noexcept -> bool { return true; };
+        static constexpr auto is_always_exhaustive() noexcept -> bool { return false; };
+        static constexpr auto is_always_strided() noexcept -> bool { return false; };
+        static constexpr auto is_unique() noexcept -> bool { return true; };
+        constexpr auto is_exhaustive() const noexcept -> bool
+        {
+            return bounds.extent(0) % tile_rows == 0 and bounds.extent(1) % tile_columns == 0;
+        };
+        static constexpr auto is_strided() noexcept -> bool { return false; };
+
+        friend constexpr auto operator ==(const mapping& left, const mapping& right) noexcept -> bool
+        {
+            return left.bounds == right.bounds;
+        };
+    };
+};
+
+struct layout_morton
+{
+    /*
+        Spreads the low 32 bits of value apart, so bit i lands on bit 2i.
+    */
+    static constexpr auto spread_bits(std::uint64_t value) noexcept -> std::uint64_t
+    {
+        value &= 0xFFFF'FFFF;
+        value = (value | value << 16) & 0x0000'FFFF'0000'FFFF;
+        value = (value | value << 8) & 0x00FF'00FF'00FF'00FF;
+        value = (value | value << 4) & 0x0F0F'0F0F'0F0F'0F0F;
+        value = (value | value << 2) & 0x3333'3333'3333'3333;
+        value = (value | value << 1) & 0x5555'5555'5555'5555;
+        return value;
+    };
+
+    /*
+        Rows and columns are each padded to a power of two. When those differ, the matrix is split into
+        squares as large as the shorter side, laid out one after the other, each in Z-order.
+    */
+    template <typename Extents>
+    struct mapping
+    {
+        static_assert(Extents::rank() == 2, "layout_morton only maps matrices");
+
+        using extents_type = Extents;
+        using index_type = typename extents_type::index_type;
+        using size_type = typename extents_type::size_type;
+        using rank_type = typename extents_type::rank_type;
+        using layout_type = layout_morton;
+
+        extents_type bounds = {};
+        // log2 of the padded row count, the padded column count, and the side of a square.
+        int row_bits = 0;
+        int column_bits = 0;
+        int square_bits = 0;
+
+        constexpr mapping() noexcept = default;
+        constexpr mapping(const extents_type& bounds) noexcept :
+            bounds{ bounds },
+            row_bits{ padded_bits(bounds.extent(0)) },
+            column_bits{ padded_bits(bounds.extent(1)) },
+            square_bits{ std::min(row_bits, column_bits) }
+        {};
+
+        static constexpr auto padded_bits(index_type extent) noexcept -> int
+        {
+            return extent > 1 ? std::bit_width(static_cast<std::uint64_t>(extent) - 1) : 0;
+        };
+
+        constexpr auto extents() const noexcept -> const extents_type&
+        {
+            return bounds;
+        };
+        constexpr auto required_span_size() const noexcept -> index_type
+        {
+            if (bounds.extent(0) == 0 or bounds.extent(1) == 0)
+            {
+                return 0;
+            }
+            return index_type{ 1 } << (row_bits + column_bits);
+        };
+
+        constexpr auto operator ()(index_type row, index_type column) const noexcept -> index_type
+        {
+            const auto square_mask = (std::uint64_t{ 1 } << square_bits) - 1;
+            const auto square = static_cast<std::uint64_t>(row >> square_bits << (column_bits - square_bits) | column >> square_bits);
+            const auto inside = spread_bits(row & square_mask) << 1 | spread_bits(column & square_mask);
+            return static_cast<index_type>(square << 2 * square_bits | inside);
+        };
+
+        static constexpr auto is_always_unique() noexcept -> bool { return true; };
+        static constexpr auto is_always_exhaustive() noexcept -> bool { return false; };
+        static constexpr auto is_always_strided() noexcept -> bool { return false; };
+        static constexpr auto is_unique() noexcept -> bool { return true; };
+        constexpr auto is_exhaustive() const noexcept -> bool
+        {
+            return required_span_size() == bounds.extent(0) * bounds.extent(1);
+        };
+        static constexpr auto is_strided() noexcept -> bool { return false; };
+
+        friend constexpr auto operator ==(const mapping& left, const mapping& right) noexcept -> bool
+        {
+            return left.bounds == right.bounds;
+        };
+    };
+};
+#endif
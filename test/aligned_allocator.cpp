@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "containers/aligned_allocator.hpp"
+
+TEST(AlignedAllocator, Alignment)
+{
+    aligned_allocator<char> allocator1{};
+    for (std::size_t count : { 1, 3, 64, 1000 })
+    {
+        char* data = allocator1.allocate(count);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % 64, 0);
+        allocator1.deallocate(data, count);
+    }
+
+    aligned_allocator<double, 4096> allocator2{};
+    double* data = allocator2.allocate(5);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % 4096, 0);
+    allocator2.deallocate(data, 5);
+};
+
+TEST(AlignedAllocator, Rebind)
+{
+    static_assert(std::same_as<std::allocator_traits<aligned_allocator<int, 128>>::rebind_alloc<char>, aligned_allocator<char, 128>>);
+    static_assert(dynamic_buffer<int, aligned_allocator<int>>::is_bulk_copyable);
+};
+
+TEST(AlignedBuffer, Construction)
+{
+    aligned_buffer<float> buffer1(100, 1.5f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer1.data) % 64, 0);
+    EXPECT_EQ(buffer1[99], 1.5f);
+
+    aligned_buffer<float> buffer2{ buffer1 };
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer2.data) % 64, 0);
+    EXPECT_EQ(buffer2, buffer1);
+
+    buffer2.resize(1000, 2.0f);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer2.data) % 64, 0);
+    EXPECT_EQ(buffer2[99], 1.5f);
+    EXPECT_EQ(buffer2[999], 2.0f);
+};
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <thread>
+#include "containers/binary_io.hpp"
+
+#if CONTAINERS_HAS_UIO
+#include <fcntl.h>
+
+namespace
+{
+    auto temporary_file(const char* name) -> std::filesystem::path
+    {
+        return std::filesystem::temp_directory_path() / name;
+    };
+
+    auto expect_format_error(auto&& read) -> void
+    {
+        try
+        {
+            read();
+            ADD_FAILURE() << "expected a format error";
+        }
+        catch (const std::system_error& error)
+        {
+            EXPECT_EQ(error.code(), std::errc::illegal_byte_sequence);
+        }
+    };
+};
+
+TEST(BinaryIo, DescriptorRoundTrip)
+{
+    const auto path = temporary_file("containers_binary_io_descriptor.bin");
+    dynamic_buffer<std::uint64_t> written(1000);
+    std::iota(written.begin(), written.end(), 0);
+
+    const int output = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASSERT_GE(output, 0);
+    write_buffer(output, written);
+    ::close(output);
+    EXPECT_EQ(std::filesystem::file_size(path), sizeof(buffer_header) + 1000 * sizeof(std::uint64_t));
+
+    const int input = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(input, 0);
+    const auto read = read_buffer<std::uint64_t>(input);
+    ::close(input);
+    EXPECT_EQ(read, written);
+    EXPECT_EQ(read.capacity, 1000);
+
+    std::filesystem::remove(path);
+};
+
+TEST(BinaryIo, StreamRoundTrip)
+{
+    std::FILE* stream = std::tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    const dynamic_buffer<float> first{ 1.0f, 2.0f, 3.0f };
+    const dynamic_buffer<float> empty{};
+    write_buffer(stream, first);
+    write_buffer(stream, empty);
+    std::rewind(stream);
+
+    dynamic_buffer<float> read(8, 0.0f);
+    float* const storage = std::to_address(read.data);
+    read_buffer(stream, read);
+    EXPECT_EQ(read, first);
+    EXPECT_EQ(std::to_address(read.data), storage);
+
+    EXPECT_EQ(read_buffer<float>(stream).size, 0);
+    std::fclose(stream);
+};
+
+TEST(BinaryIo, BareElements)
+{
+    std::FILE* stream = std::tmpfile();
+    ASSERT_NE(stream, nullptr);
+
+    const std::int16_t values[] = { 5, -6, 7 };
+    write_elements(stream, std::span{ values });
+    std::rewind(stream);
+
+    dynamic_buffer<std::int16_t> read{ uninitialized, 3 };
+    read_elements(stream, std::span{ std::to_address(read.data), read.size });
+    EXPECT_EQ(read, (dynamic_buffer<std::int16_t>{ 5, -6, 7 }));
+
+    std::int16_t more[1];
+    expect_format_error([&] { read_elements(stream, std::span{ more }); });
+    std::fclose(stream);
+};
+
+TEST(BinaryIo, ShortTransfers)
+{
+    int ends[2];
+    ASSERT_EQ(::pipe(ends), 0);
+
+    // larger than a pipe holds, so both sides see partial writes and reads.
+    dynamic_buffer<std::uint32_t> written(1 << 20);
+    std::iota(written.begin(), written.end(), 0u);
+    std::thread writer{ [&] { write_buffer(ends[1], written); ::close(ends[1]); } };
+
+    const auto read = read_buffer<std::uint32_t>(ends[0]);
+    writer.join();
+    ::close(ends[0]);
+    EXPECT_EQ(read, written);
+};
+
+TEST(BinaryIo, Validation)
+{
+    std::FILE* stream = std::tmpfile();
+    ASSERT_NE(stream, nullptr);
+    write_buffer(stream, dynamic_buffer<std::uint32_t>{ 1, 2, 3, 4 });
+
+    std::rewind(stream);
+    expect_format_error([&] { read_buffer<std::uint64_t>(stream); });
+
+    // flip a bit in the last element.
+    std::fseek(stream, -1, SEEK_END);
+    std::fputc(0x80, stream);
+    std::rewind(stream);
+    dynamic_buffer<std::uint32_t> read(2, 9u);
+    expect_format_error([&] { read_buffer(stream, read); });
+    EXPECT_EQ(read.size, 0);
+
+    std::rewind(stream);
+    std::fputc('X', stream);
+    std::rewind(stream);
+    expect_format_error([&] { read_buffer<std::uint32_t>(stream); });
+
+    // a header that fails its checks empties the buffer too, nothing stale survives a failed read.
+    std::rewind(stream);
+    read = dynamic_buffer<std::uint32_t>{ 7, 8, 9 };
+    expect_format_error([&] { read_buffer(stream, read); });
+    EXPECT_EQ(read.size, 0);
+    std::fclose(stream);
+
+    const auto path = temporary_file("containers_binary_io_truncated.bin");
+    const int output = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASSERT_GE(output, 0);
+    write_buffer(output, dynamic_buffer<std::uint32_t>{ 1, 2, 3, 4 });
+    ::ftruncate(output, sizeof(buffer_header) + 6);
+    ::close(output);
+
+    const int input = ::open(path.c_str(), O_RDONLY);
+    expect_format_error([&] { read_buffer<std::uint32_t>(input); });
+    ::close(input);
+    std::filesystem::remove(path);
+};
+
+TEST(BinaryIo, OversizedCount)
+{
+    // a header claiming far more elements than follow it is rejected before the buffer is sized.
+    buffer_header header = make_header(std::span<const std::uint32_t>{});
+    header.count = std::uint64_t{ 1 } << 50;
+
+    const std::uint32_t elements[] = { 1, 2, 3 };
+
+    std::FILE* stream = std::tmpfile();
+    ASSERT_NE(stream, nullptr);
+    write_elements(stream, std::span{ &header, 1 });
+    write_elements(stream, std::span{ elements });
+    std::rewind(stream);
+    dynamic_buffer<std::uint32_t> read(2, 9u);
+    expect_format_error([&] { read_buffer(stream, read); });
+    EXPECT_EQ(read.size, 0);
+    std::fclose(stream);
+
+    const auto path = temporary_file("containers_binary_io_oversized.bin");
+    const int output = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    ASSERT_GE(output, 0);
+    write_elements(output, std::span{ &header, 1 });
+    ::close(output);
+
+    const int input = ::open(path.c_str(), O_RDONLY);
+    expect_format_error([&] { read_buffer<std::uint32_t>(input); });
+    ::close(input);
+    std::filesystem::remove(path);
+};
+#endif
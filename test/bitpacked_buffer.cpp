@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+#include "containers/bitpacked_buffer.hpp"
+
+static_assert(std::random_access_iterator<bitpacked_buffer<12>::iterator>);
+static_assert(std::random_access_iterator<bitpacked_buffer<12>::const_iterator>);
+static_assert(sizeof(bitpacked_buffer<12>) < sizeof(bitpacked_buffer<>));
+
+namespace
+{
+    // a pattern that reaches the top bit of the width and differs between neighbours.
+    auto pattern(std::size_t count, std::size_t width) -> std::vector<std::uint32_t>
+    {
+        const std::uint32_t mask = ~std::uint32_t{ 0 } >> (32 - width);
+        std::vector<std::uint32_t> values(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            values[i] = static_cast<std::uint32_t>(i * 2654435761u) & mask;
+        }
+        return values;
+    };
+};
+
+TEST(BitpackedBuffer, Construction)
+{
+    bitpacked_buffer<12> empty{};
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.words.size, 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    bitpacked_buffer<12> zeros(1000);
+    EXPECT_EQ(zeros.size, 1000);
+    // whole blocks, and one row of padding.
+    EXPECT_EQ(zeros.words.size, 4 * 12 * 8 + 8);
+    EXPECT_TRUE(std::all_of(zeros.begin(), zeros.end(), [](std::uint32_t value) { return value == 0; }));
+    EXPECT_EQ(zeros.max_value(), 4095);
+
+    bitpacked_buffer<> runtime(5, 300);
+    EXPECT_EQ(runtime.width, 5);
+    EXPECT_EQ(runtime.max_value(), 31);
+    EXPECT_EQ(runtime.words.size, 2 * 5 * 8 + 8);
+};
+
+TEST(BitpackedBuffer, RandomAccess)
+{
+    for (std::size_t width : { 1, 3, 7, 12, 17, 31, 32 })
+    {
+        // a whole number of blocks, so the last values are read together with the padding.
+        const auto values = pattern(1024, width);
+        bitpacked_buffer<> buffer(width, values.size());
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            buffer[i] = values[i];
+        }
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            ASSERT_EQ(buffer[i], values[i]);
+        }
+
+        // overwriting one value leaves its neighbours alone.
+        buffer[500] = buffer.max_value();
+        EXPECT_EQ(buffer[499], values[499]);
+        EXPECT_EQ(buffer[500], buffer.max_value());
+        EXPECT_EQ(buffer[501], values[501]);
+    }
+};
+
+TEST(BitpackedBuffer, PackUnpack)
+{
+    const auto values = pattern(3000, 12);
+
+    const bitpacked_buffer<12> fixed{ std::span<const std::uint32_t>{ values } };
+    const bitpacked_buffer<> runtime{ 12, std::span<const std::uint32_t>{ values } };
+    for (std::size_t i = 0; i < values.size(); i += 37)
+    {
+        EXPECT_EQ(fixed[i], values[i]);
+        EXPECT_EQ(runtime[i], values[i]);
+    }
+    EXPECT_TRUE(std::equal(fixed.begin(), fixed.end(), runtime.begin()));
+
+    dynamic_buffer<std::uint32_t> unpacked;
+    fixed.unpack(unpacked);
+    EXPECT_TRUE(std::equal(unpacked.begin(), unpacked.end(), values.begin(), values.end()));
+
+    // unaligned ranges go one value at a time at either end, and whole blocks in between.
+    std::vector<std::uint16_t> middle(1000);
+    runtime.unpack(100, std::span{ middle });
+    EXPECT_TRUE(std::equal(middle.begin(), middle.end(), values.begin() + 100));
+
+    bitpacked_buffer<12> patched{ fixed };
+    const std::vector<std::uint64_t> replacement(700, 0xFFFF'0ABC);
+    patched.pack(300, std::span<const std::uint64_t>{ replacement });
+    EXPECT_EQ(patched[299], values[299]);
+    EXPECT_EQ(patched[300], 0xABC);
+    EXPECT_EQ(patched[999], 0xABC);
+    EXPECT_EQ(patched[1000], values[1000]);
+};
+
+TEST(BitpackedBuffer, Resize)
+{
+    bitpacked_buffer<9> buffer(10);
+    buffer.resize(700, 300);
+    EXPECT_EQ(buffer[9], 0);
+    EXPECT_TRUE(std::all_of(buffer.begin() + 10, buffer.end(), [](std::uint32_t value) { return value == 300; }));
+
+    buffer.resize(5);
+    EXPECT_EQ(buffer.words.size, 9 * 8 + 8);
+    buffer.resize(20);
+    EXPECT_EQ(buffer[4], 0);
+    EXPECT_EQ(buffer[5], 0);
+    EXPECT_EQ(buffer[19], 0);
+
+    buffer.release_storage();
+    EXPECT_EQ(buffer.size, 0);
+    EXPECT_EQ(buffer.words.size, 0);
+};
+
+TEST(BitpackedBuffer, CopyMoveCompare)
+{
+    const auto values = pattern(600, 20);
+    bitpacked_buffer<20> first{ std::span<const std::uint32_t>{ values } };
+    bitpacked_buffer<20> second{ first };
+    EXPECT_EQ(first, second);
+
+    second[3] = second[3] ^ 1;
+    EXPECT_NE(first, second);
+
+    bitpacked_buffer<20> moved{ std::move(second) };
+    EXPECT_EQ(second.size, 0);
+    EXPECT_EQ(moved.size, 600);
+
+    first = moved;
+    EXPECT_EQ(first, moved);
+
+    bitpacked_buffer<> narrow(20, std::span<const std::uint32_t>{ values });
+    bitpacked_buffer<> wide(32, std::span<const std::uint32_t>{ values });
+    EXPECT_EQ(narrow, wide);
+};
+
+TEST(BitpackedBuffer, Algorithms)
+{
+    bitpacked_buffer<10> buffer(300);
+    std::iota(buffer.begin(), buffer.end(), 0u);
+    std::reverse(buffer.begin(), buffer.end());
+    EXPECT_EQ(buffer[0], 299);
+    EXPECT_EQ(buffer[299], 0);
+
+    std::ranges::sort(buffer);
+    EXPECT_TRUE(std::ranges::is_sorted(buffer));
+    EXPECT_EQ(*std::ranges::max_element(std::as_const(buffer)), 299);
+};
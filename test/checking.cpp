@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include "containers/checking.hpp"
+#include "containers/dynamic_buffer.hpp"
+
+static_assert((no_checking::check(false), true));
+static_assert((always_checking::check(true), true));
+static_assert((sampled_checking<3>::check(true), true));
+
+TEST(Checking, NoChecking)
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        no_checking::check(false);
+    }
+};
+
+TEST(Checking, AlwaysChecking)
+{
+    always_checking::check(true);
+    EXPECT_DEATH(always_checking::check(false), "check failed");
+};
+
+TEST(Checking, AssertChecking)
+{
+    assert_checking::check(true);
+#ifndef NDEBUG
+    EXPECT_DEATH(assert_checking::check(false), "");
+#endif
+};
+
+TEST(Checking, SampledChecking)
+{
+    // only every fourth access is looked at, the first three failures go unnoticed.
+    for (int i = 0; i < 3; ++i)
+    {
+        sampled_checking<4>::check(false);
+    }
+    EXPECT_DEATH(sampled_checking<4>::check(false), "check failed");
+
+    // every thread counts on its own.
+    std::thread other{ []
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            sampled_checking<4>::check(false);
+        }
+    } };
+    other.join();
+};
+
+TEST(Checking, DefaultChecking)
+{
+    dynamic_buffer<int> buffer(4, 1);
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        check_index(i, buffer.size);
+        EXPECT_EQ(buffer[i], 1);
+    }
+#if CONTAINERS_CHECKING == 2 or (CONTAINERS_CHECKING == 1 and not defined(NDEBUG))
+    EXPECT_DEATH(buffer[4], "");
+#endif
+};
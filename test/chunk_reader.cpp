@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "containers/chunk_reader.hpp"
+
+#if CONTAINERS_HAS_UNISTD
+namespace
+{
+    auto write_file(const std::filesystem::path& path, std::size_t bytes) -> std::vector<std::uint8_t>
+    {
+        std::vector<std::uint8_t> contents(bytes);
+        std::iota(contents.begin(), contents.end(), std::uint8_t{ 0 });
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char*>(contents.data()), contents.size());
+        return contents;
+    };
+
+    auto temporary_file(const char* name) -> std::filesystem::path
+    {
+        return std::filesystem::temp_directory_path() / name;
+    };
+
+    auto read_all(chunk_reader& reader, std::vector<std::size_t>& sizes) -> std::vector<std::uint8_t>
+    {
+        std::vector<std::uint8_t> contents;
+        for (std::span<const std::byte> chunk = reader.next(); not chunk.empty(); chunk = reader.next())
+        {
+            sizes.push_back(chunk.size());
+            const auto* bytes = reinterpret_cast<const std::uint8_t*>(chunk.data());
+            contents.insert(contents.end(), bytes, bytes + chunk.size());
+        }
+        return contents;
+    };
+};
+
+TEST(ChunkReader, ReadsWholeFile)
+{
+    const auto path = temporary_file("containers_chunk_reader.bin");
+    const auto contents = write_file(path, 10'000);
+
+    for (std::size_t depth : { 1, 2, 5 })
+    {
+        const int descriptor = ::open(path.c_str(), O_RDONLY);
+        ASSERT_GE(descriptor, 0);
+        {
+            chunk_reader reader{ descriptor, 4096, depth };
+            std::vector<std::size_t> sizes;
+            EXPECT_EQ(read_all(reader, sizes), contents);
+            EXPECT_EQ(sizes, (std::vector<std::size_t>{ 4096, 4096, 1808 }));
+            EXPECT_TRUE(reader.next().empty());
+        }
+        ::close(descriptor);
+    }
+
+    std::filesystem::remove(path);
+};
+
+TEST(ChunkReader, RecyclesChunks)
+{
+    const auto path = temporary_file("containers_chunk_reader_recycle.bin");
+    write_file(path, 64 * 1024);
+
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(descriptor, 0);
+    {
+        chunk_reader reader{ descriptor, 1024, 3 };
+        std::vector<const std::byte*> chunks;
+        for (std::span<const std::byte> chunk = reader.next(); not chunk.empty(); chunk = reader.next())
+        {
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(chunk.data()) % chunk_reader::chunk_alignment, 0);
+            chunks.push_back(chunk.data());
+        }
+        EXPECT_EQ(chunks.size(), 64);
+        for (std::size_t i = 3; i < chunks.size(); ++i)
+        {
+            EXPECT_EQ(chunks[i], chunks[i - 3]);
+        }
+    }
+    ::close(descriptor);
+
+    std::filesystem::remove(path);
+};
+
+TEST(ChunkReader, EmptyFile)
+{
+    const auto path = temporary_file("containers_chunk_reader_empty.bin");
+    write_file(path, 0);
+
+    const int descriptor = ::open(path.c_str(), O_RDONLY);
+    ASSERT_GE(descriptor, 0);
+    {
+        chunk_reader reader{ descriptor, 4096 };
+        EXPECT_TRUE(reader.next().empty());
+        EXPECT_TRUE(reader.next().empty());
+    }
+    ::close(descriptor);
+
+    std::filesystem::remove(path);
+};
+
+TEST(ChunkReader, ShortReads)
+{
+    int ends[2];
+    ASSERT_EQ(::pipe(ends), 0);
+
+    // a pipe hands out whatever has been written so far, so chunks are assembled from several reads.
+    std::thread writer{ [&]
+    {
+        for (std::uint8_t i = 0; i < 100; ++i)
+        {
+            const std::uint8_t piece[7] = { i, i, i, i, i, i, i };
+            (void)::write(ends[1], piece, sizeof(piece));
+        }
+        ::close(ends[1]);
+    } };
+
+    {
+        chunk_reader reader{ ends[0], 256 };
+        std::vector<std::size_t> sizes;
+        const auto contents = read_all(reader, sizes);
+        EXPECT_EQ(contents.size(), 700);
+        EXPECT_EQ(contents[699], 99);
+        EXPECT_EQ(sizes, (std::vector<std::size_t>{ 256, 256, 188 }));
+    }
+    writer.join();
+    ::close(ends[0]);
+};
+
+TEST(ChunkReader, StopsEarly)
+{
+    int ends[2];
+    ASSERT_EQ(::pipe(ends), 0);
+    const std::uint8_t piece[64] = {};
+    for (int i = 0; i < 8; ++i)
+    {
+        (void)::write(ends[1], piece, sizeof(piece));
+    }
+
+    {
+        // the filler is left waiting for a free slot, and for more data, when the reader goes away.
+        chunk_reader reader{ ends[0], 64, 2 };
+        EXPECT_EQ(reader.next().size(), 64);
+    }
+    {
+        chunk_reader reader{ ends[0], 4096, 2 };
+    }
+    ::close(ends[1]);
+    ::close(ends[0]);
+};
+
+TEST(ChunkReader, ReadError)
+{
+    chunk_reader reader{ -1, 4096 };
+    EXPECT_THROW(reader.next(), std::system_error);
+    EXPECT_TRUE(reader.next().empty());
+};
+#endif
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "containers/dynamic_bitset.hpp"
+
+namespace
+{
+    auto random_bits(std::size_t size, double density, unsigned seed) -> std::vector<bool>
+    {
+        std::mt19937 engine{ seed };
+        std::bernoulli_distribution distribution{ density };
+        std::vector<bool> bits(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            bits[i] = distribution(engine);
+        }
+        return bits;
+    };
+
+    auto to_bitset(const std::vector<bool>& bits) -> dynamic_bitset<>
+    {
+        dynamic_bitset<> result(bits.size());
+        for (std::size_t i = 0; i < bits.size(); ++i)
+        {
+            result.set(i, bits[i]);
+        }
+        return result;
+    };
+};
+
+TEST(DynamicBitset, Construction)
+{
+    dynamic_bitset<> empty{};
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.count(), 0);
+    EXPECT_EQ(empty.find_first(), dynamic_bitset<>::npos);
+    EXPECT_TRUE(empty.none());
+    EXPECT_TRUE(empty.all());
+
+    dynamic_bitset<> ones(100, true);
+    EXPECT_EQ(ones.words.size, 2);
+    EXPECT_EQ(ones.count(), 100);
+    EXPECT_EQ(ones.words[1], (std::uint64_t{ 1 } << 36) - 1);
+    EXPECT_TRUE(ones.all());
+};
+
+TEST(DynamicBitset, SingleBits)
+{
+    dynamic_bitset<> bits(130);
+    bits.set(0);
+    bits.set(64);
+    bits.set(129);
+    bits.flip(5);
+    EXPECT_TRUE(bits[0]);
+    EXPECT_TRUE(bits.test(5));
+    EXPECT_FALSE(bits[6]);
+    EXPECT_EQ(bits.count(), 4);
+
+    bits.reset(64);
+    bits.flip(5);
+    EXPECT_FALSE(bits[64]);
+    EXPECT_FALSE(bits[5]);
+    EXPECT_EQ(bits.count(), 2);
+
+    bits.flip();
+    EXPECT_EQ(bits.count(), 128);
+    bits.set();
+    EXPECT_TRUE(bits.all());
+    bits.reset();
+    EXPECT_TRUE(bits.none());
+};
+
+TEST(DynamicBitset, BulkOperations)
+{
+    const auto left_bits = random_bits(1000, 0.5, 1);
+    const auto right_bits = random_bits(1000, 0.3, 2);
+    const auto left = to_bitset(left_bits);
+    const auto right = to_bitset(right_bits);
+
+    auto both = left;
+    both &= right;
+    auto either = left;
+    either |= right;
+    auto one = left;
+    one ^= right;
+    auto only = left;
+    only.and_not(right);
+
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_EQ(both[i], left_bits[i] and right_bits[i]);
+        EXPECT_EQ(either[i], left_bits[i] or right_bits[i]);
+        EXPECT_EQ(one[i], left_bits[i] != right_bits[i]);
+        EXPECT_EQ(only[i], left_bits[i] and not right_bits[i]);
+    }
+
+    EXPECT_EQ(left & right, both);
+    EXPECT_EQ(left | right, either);
+    EXPECT_EQ(left ^ right, one);
+    EXPECT_EQ(and_not(left, right), only);
+
+    auto self = left;
+    self &= self;
+    EXPECT_EQ(self, left);
+    self ^= self;
+    EXPECT_TRUE(self.none());
+};
+
+TEST(DynamicBitset, Count)
+{
+    for (std::size_t size : { 1, 63, 64, 65, 2000, 5000 })
+    {
+        const auto bits = random_bits(size, 0.4, static_cast<unsigned>(size));
+        EXPECT_EQ(to_bitset(bits).count(), static_cast<std::size_t>(std::count(bits.begin(), bits.end(), true)));
+    }
+};
+
+TEST(DynamicBitset, Find)
+{
+    dynamic_bitset<> bits(1000);
+    const std::vector<std::size_t> positions = { 3, 63, 64, 500, 999 };
+    for (std::size_t position : positions)
+    {
+        bits.set(position);
+    }
+
+    std::vector<std::size_t> found;
+    for (std::size_t i = bits.find_first(); i != bits.npos; i = bits.find_next(i))
+    {
+        found.push_back(i);
+    }
+    EXPECT_EQ(found, positions);
+    EXPECT_EQ(bits.find_next(999), bits.npos);
+    EXPECT_EQ(bits.find_next(bits.npos), bits.npos);
+};
+
+TEST(DynamicBitset, Resize)
+{
+    dynamic_bitset<> bits(10, true);
+    bits.resize(100, true);
+    EXPECT_EQ(bits.count(), 100);
+    bits.resize(200);
+    EXPECT_EQ(bits.count(), 100);
+    EXPECT_FALSE(bits[150]);
+
+    bits.resize(70);
+    EXPECT_EQ(bits.count(), 70);
+    bits.resize(72, false);
+    EXPECT_EQ(bits.count(), 70);
+    EXPECT_EQ(bits.find_from(70), bits.npos);
+
+    dynamic_bitset<> moved{ std::move(bits) };
+    EXPECT_EQ(bits.size, 0);
+    EXPECT_EQ(moved.size, 72);
+    moved.release_storage();
+    EXPECT_EQ(moved.words.size, 0);
+};
+
+TEST(DynamicBitset, RankSelect)
+{
+    for (double density : { 0.01, 0.5, 0.99 })
+    {
+        const auto values = random_bits(5000, density, 3);
+        const auto bits = to_bitset(values);
+        const rank_select_index index{ bits };
+
+        std::size_t rank = 0;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            ASSERT_EQ(index.rank(i), rank);
+            if (values[i])
+            {
+                ASSERT_EQ(index.select(rank), i);
+                ++rank;
+            }
+        }
+        EXPECT_EQ(index.rank(values.size()), rank);
+        EXPECT_EQ(index.total(), rank);
+        EXPECT_EQ(index.select(rank), index.npos);
+    }
+
+    EXPECT_EQ(select_word_bit(0x8000'0000'0000'0001, 1), 63);
+    EXPECT_EQ(select_word_bit(0xFF00, 3), 11);
+};
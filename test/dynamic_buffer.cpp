@@ -1,4 +1,10 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <vector>
 #include "containers/dynamic_buffer.hpp"
 
 TEST(DynamicBuffer, DefaultConstruction)
@@ -94,6 +100,49 @@ TEST(DynamicBuffer, UninitializedConstruction)
     EXPECT_NE(buffer.data, nullptr);
 };
 
+TEST(DynamicBuffer, BulkConstruction)
+{
+    static_assert(dynamic_buffer<int>::is_bulk_copyable);
+    static_assert(dynamic_buffer<int>::is_bulk_destructible);
+    static_assert(dynamic_buffer<int>::is_zero_fillable);
+    static_assert(not dynamic_buffer<std::string>::is_bulk_copyable);
+    static_assert(not dynamic_buffer<std::string>::is_bulk_destructible);
+    static_assert(not dynamic_buffer<std::string>::is_zero_fillable);
+
+    dynamic_buffer<double> buffer1(1000);
+    for (std::size_t i = 0; i < buffer1.size; ++i)
+    {
+        EXPECT_EQ(buffer1[i], 0.0);
+    }
+
+    dynamic_buffer<char> buffer2(1000, 'x');
+    dynamic_buffer<char> buffer3{ buffer2 };
+    for (std::size_t i = 0; i < buffer3.size; ++i)
+    {
+        EXPECT_EQ(buffer3[i], 'x');
+    }
+
+    buffer3.resize(1500, 'y');
+    EXPECT_EQ(buffer3[999], 'x');
+    EXPECT_EQ(buffer3[1000], 'y');
+    EXPECT_EQ(buffer3[1499], 'y');
+};
+
+TEST(DynamicBuffer, NonTrivialConstruction)
+{
+    dynamic_buffer<std::string> buffer1(3, "abc");
+    dynamic_buffer<std::string> buffer2{ buffer1 };
+    for (std::size_t i = 0; i < buffer2.size; ++i)
+    {
+        EXPECT_EQ(buffer2[i], "abc");
+    }
+
+    buffer2.resize(5, "de");
+    EXPECT_EQ(buffer2[2], "abc");
+    EXPECT_EQ(buffer2[3], "de");
+    EXPECT_EQ(buffer2[4], "de");
+};
+
 TEST(DynamicBuffer, CopyAssignment)
 {
     static_assert(std::is_copy_assignable_v<dynamic_buffer<int>>);
@@ -189,7 +238,11 @@ TEST(DynamicBuffer, Spaceship)
     EXPECT_EQ(buffer1 <=> buffer4, std::partial_ordering::less);
     EXPECT_EQ(buffer1 <=> buffer5, std::partial_ordering::less);
     EXPECT_EQ(buffer1 <=> buffer6, std::partial_ordering::greater);
-    EXPECT_EQ(buffer1 <=> buffer7, std::partial_ordering::unordered);
+    EXPECT_EQ(buffer1 <=> buffer7, std::partial_ordering::greater);
+    EXPECT_EQ(buffer7 <=> buffer1, std::partial_ordering::less);
+    EXPECT_EQ(buffer7 <=> dynamic_buffer<int>{}, std::partial_ordering::equivalent);
+    EXPECT_EQ(buffer3 <=> buffer5, std::partial_ordering::less);
+    EXPECT_EQ(buffer5 <=> buffer4, std::partial_ordering::greater);
 };
 
 TEST(DynamicBuffer, Resize)
@@ -246,6 +299,147 @@ TEST(DynamicBuffer, ResizeUninitialized)
     // no real way to check "are the last three uninitialized memory."
 };
 
+TEST(DynamicBuffer, ResizeMovesElements)
+{
+    dynamic_buffer<std::string> buffer = { std::string(100, 'a'), std::string(100, 'b') };
+    const char* first_data = buffer[0].data();
+
+    buffer.resize(4, "c");
+    EXPECT_EQ(buffer.size, 4);
+    EXPECT_EQ(buffer[0].data(), first_data);
+    EXPECT_EQ(buffer[1], std::string(100, 'b'));
+    EXPECT_EQ(buffer[3], "c");
+
+    buffer.resize(1);
+    EXPECT_EQ(buffer.size, 1);
+    EXPECT_EQ(buffer[0].data(), first_data);
+};
+
+struct throwing
+{
+    static inline int copies_left = 0;
+    static inline int alive = 0;
+
+    int value = 0;
+
+    throwing(int value = 0) : value{ value } { ++alive; };
+    throwing(const throwing& other) : value{ other.value }
+    {
+        if (copies_left-- == 0)
+        {
+            throw 0;
+        }
+        ++alive;
+    };
+    ~throwing() { --alive; };
+};
+
+TEST(DynamicBuffer, ResizeStrongGuarantee)
+{
+    static_assert(not std::is_nothrow_move_constructible_v<throwing>);
+
+    throwing::copies_left = 100;
+    {
+        dynamic_buffer<throwing> buffer = { 1, 2, 3, 4 };
+        throwing* buffer_data = buffer.data;
+        EXPECT_EQ(throwing::alive, 4);
+
+        throwing::copies_left = 2;
+        EXPECT_ANY_THROW(buffer.resize(8, throwing{ 9 }));
+        EXPECT_EQ(throwing::alive, 4);
+        EXPECT_EQ(buffer.size, 4);
+
+        throwing::copies_left = 2;
+        EXPECT_ANY_THROW(buffer.resize(8, 9));
+        EXPECT_EQ(throwing::alive, 4);
+        EXPECT_EQ(buffer.size, 4);
+        EXPECT_EQ(buffer.data, buffer_data);
+        EXPECT_EQ(buffer[3].value, 4);
+
+        throwing::copies_left = 0;
+        EXPECT_NO_THROW(buffer.resize(3));
+        EXPECT_EQ(throwing::alive, 3);
+        EXPECT_EQ(buffer.size, 3);
+        EXPECT_EQ(buffer.data, buffer_data);
+
+        throwing::copies_left = 100;
+        EXPECT_NO_THROW(buffer.resize(6, 5));
+        EXPECT_EQ(throwing::alive, 6);
+        EXPECT_EQ(buffer[2].value, 3);
+        EXPECT_EQ(buffer[0].value, 1);
+        EXPECT_EQ(buffer[5].value, 5);
+
+        throwing::copies_left = 3;
+        EXPECT_ANY_THROW(dynamic_buffer<throwing>{ buffer });
+        EXPECT_EQ(throwing::alive, 6);
+    }
+    EXPECT_EQ(throwing::alive, 0);
+};
+
+template <typename T>
+struct slack_allocator : std::allocator<T>
+{
+    using value_type = T;
+
+    struct allocation_result
+    {
+        T* ptr;
+        std::size_t count;
+    };
+
+    slack_allocator() = default;
+    template <typename U>
+    slack_allocator(const slack_allocator<U>&) {};
+
+    auto allocate_at_least(std::size_t count) -> allocation_result
+    {
+        return { this->allocate(count * 2), count * 2 };
+    };
+};
+
+TEST(DynamicBuffer, ResizeWithinCapacity)
+{
+    dynamic_buffer<int, slack_allocator<int>> buffer(4, 1);
+    int* buffer_data = buffer.data;
+    EXPECT_EQ(buffer.size, 4);
+    EXPECT_EQ(buffer.capacity, 8);
+
+    buffer.resize(8, 2);
+    EXPECT_EQ(buffer.data, buffer_data);
+    EXPECT_EQ(buffer.size, 8);
+    EXPECT_EQ(buffer[3], 1);
+    EXPECT_EQ(buffer[7], 2);
+
+    buffer.resize(2);
+    EXPECT_EQ(buffer.data, buffer_data);
+    EXPECT_EQ(buffer.size, 2);
+    EXPECT_EQ(buffer.capacity, 8);
+
+    buffer.resize(9, buffer[1]);
+    EXPECT_NE(buffer.data, buffer_data);
+    EXPECT_EQ(buffer.size, 9);
+    EXPECT_EQ(buffer.capacity, 18);
+    EXPECT_EQ(buffer[8], 1);
+
+    buffer.resize(0);
+    EXPECT_EQ(buffer.size, 0);
+    EXPECT_EQ(buffer.capacity, 0);
+    EXPECT_EQ(buffer.data, nullptr);
+};
+
+TEST(DynamicBuffer, ShrinkToFit)
+{
+    dynamic_buffer<std::string> buffer = { "a", "b", "c", "d" };
+    buffer.resize(2);
+    EXPECT_EQ(buffer.capacity, 4);
+
+    buffer.shrink_to_fit();
+    EXPECT_EQ(buffer.size, 2);
+    EXPECT_EQ(buffer.capacity, 2);
+    EXPECT_EQ(buffer[0], "a");
+    EXPECT_EQ(buffer[1], "b");
+};
+
 TEST(DynamicBuffer, ClaimPointer)
 {
     static_assert(std::is_constructible_v<dynamic_buffer<int>, int*, std::size_t>);
@@ -261,6 +455,146 @@ TEST(DynamicBuffer, ClaimPointer)
     }
 };
 
+template <typename T, bool Propagate>
+struct tagged_allocator : std::allocator<T>
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::bool_constant<Propagate>;
+    using propagate_on_container_move_assignment = std::bool_constant<Propagate>;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = tagged_allocator<U, Propagate>;
+    };
+
+    int tag = 0;
+
+    tagged_allocator(int tag = 0) : tag{ tag } {};
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U, Propagate>& other) : tag{ other.tag } {};
+
+    auto operator ==(const tagged_allocator& other) const -> bool
+    {
+        return tag == other.tag;
+    };
+};
+
+TEST(DynamicBuffer, AllocatorExtendedConstruction)
+{
+    using allocator = tagged_allocator<int, false>;
+
+    dynamic_buffer<int, allocator> buffer1{ std::allocator_arg, allocator{ 1 }, { 1, 2, 3 } };
+    EXPECT_EQ(buffer1.allocator.tag, 1);
+    EXPECT_EQ(buffer1[2], 3);
+
+    dynamic_buffer<int, allocator> buffer2{ std::allocator_arg, allocator{ 2 }, 4, 7 };
+    EXPECT_EQ(buffer2.allocator.tag, 2);
+    EXPECT_EQ(buffer2.size, 4);
+    EXPECT_EQ(buffer2[3], 7);
+
+    dynamic_buffer<int, allocator> buffer3{ std::allocator_arg, allocator{ 3 }, uninitialized, 5 };
+    EXPECT_EQ(buffer3.allocator.tag, 3);
+    EXPECT_EQ(buffer3.size, 5);
+
+    dynamic_buffer<int, allocator> buffer4{ std::allocator_arg, allocator{ 4 }, buffer1 };
+    EXPECT_EQ(buffer4.allocator.tag, 4);
+    EXPECT_EQ(buffer4, buffer1);
+
+    dynamic_buffer<int, allocator> buffer5{ std::allocator_arg, allocator{ 4 }, std::move(buffer4) };
+    EXPECT_EQ(buffer5.allocator.tag, 4);
+    EXPECT_EQ(buffer5, buffer1);
+    EXPECT_EQ(buffer4.data, nullptr);
+
+    int* data = buffer1.data;
+    dynamic_buffer<int, allocator> buffer6{ std::allocator_arg, allocator{ 5 }, std::move(buffer1) };
+    EXPECT_EQ(buffer6.allocator.tag, 5);
+    EXPECT_NE(buffer6.data, data);
+    EXPECT_EQ(buffer6[0], 1);
+    EXPECT_EQ(buffer1.size, 0);
+    EXPECT_EQ(buffer1.data, nullptr);
+
+    dynamic_buffer<int, allocator> buffer7{ allocator{ 6 } };
+    EXPECT_EQ(buffer7.allocator.tag, 6);
+    EXPECT_EQ(buffer7.size, 0);
+
+    dynamic_buffer<int, allocator> buffer8{ std::move(buffer6) };
+    EXPECT_EQ(buffer8.allocator.tag, 5);
+    EXPECT_EQ(buffer8[2], 3);
+};
+
+TEST(DynamicBuffer, AllocatorPropagation)
+{
+    {
+        using allocator = tagged_allocator<int, false>;
+        dynamic_buffer<int, allocator> source{ std::allocator_arg, allocator{ 1 }, { 1, 2, 3 } };
+        dynamic_buffer<int, allocator> buffer{ std::allocator_arg, allocator{ 2 } };
+
+        buffer = source;
+        EXPECT_EQ(buffer.allocator.tag, 2);
+        EXPECT_EQ(buffer, source);
+
+        buffer = std::move(source);
+        EXPECT_EQ(buffer.allocator.tag, 2);
+        EXPECT_EQ(buffer[2], 3);
+        EXPECT_EQ(source.size, 0);
+    }
+    {
+        using allocator = tagged_allocator<int, true>;
+        dynamic_buffer<int, allocator> source{ std::allocator_arg, allocator{ 1 }, { 1, 2, 3 } };
+        dynamic_buffer<int, allocator> buffer{ std::allocator_arg, allocator{ 2 }, 8, 0 };
+
+        buffer = source;
+        EXPECT_EQ(buffer.allocator.tag, 1);
+        EXPECT_EQ(buffer, source);
+
+        int* data = source.data;
+        dynamic_buffer<int, allocator> other{ std::allocator_arg, allocator{ 3 } };
+        other = std::move(source);
+        EXPECT_EQ(other.allocator.tag, 1);
+        EXPECT_EQ(other.data, data);
+    }
+};
+
+TEST(DynamicBuffer, CopyAssignmentReusesStorage)
+{
+    dynamic_buffer<int> source{ 1, 2, 3 };
+    dynamic_buffer<int> buffer(8, 0);
+    int* data = buffer.data;
+
+    buffer = source;
+    EXPECT_EQ(buffer.data, data);
+    EXPECT_EQ(buffer.capacity, 8);
+    EXPECT_EQ(buffer, source);
+};
+
+TEST(DynamicBuffer, PolymorphicAllocator)
+{
+    static_assert(pmr::dynamic_buffer<int>::is_bulk_copyable);
+    static_assert(pmr::dynamic_buffer<int>::is_bulk_relocatable);
+    static_assert(not pmr::dynamic_buffer<std::pmr::string>::is_bulk_copyable);
+
+    std::byte arena[1024];
+    std::pmr::monotonic_buffer_resource resource{ arena, sizeof(arena), std::pmr::null_memory_resource() };
+
+    pmr::dynamic_buffer<int> buffer1{ std::allocator_arg, &resource, 16, 5 };
+    EXPECT_GE(reinterpret_cast<std::byte*>(buffer1.data), arena);
+    EXPECT_LT(reinterpret_cast<std::byte*>(buffer1.data), arena + sizeof(arena));
+    EXPECT_EQ(buffer1[15], 5);
+
+    pmr::dynamic_buffer<int> buffer2{ &resource };
+    buffer2 = buffer1;
+    EXPECT_EQ(buffer2.allocator.resource(), &resource);
+    EXPECT_EQ(buffer2, buffer1);
+
+    pmr::dynamic_buffer<int> buffer3{ buffer1 };
+    EXPECT_EQ(buffer3.allocator.resource(), std::pmr::get_default_resource());
+
+    pmr::dynamic_buffer<std::pmr::string> strings{ std::allocator_arg, &resource, 2, "a string long enough to allocate" };
+    EXPECT_EQ(strings[1].get_allocator().resource(), &resource);
+};
+
 TEST(DynamicBufferIterator, InputIterator)
 {
     static_assert(std::input_iterator<dynamic_buffer_iterator<int>>);
@@ -628,4 +962,188 @@ TEST(DynamicBuffer, Iterators)
         EXPECT_EQ(*itr, index2);
         --index2;
     }
-};
\ No newline at end of file
+};
+struct counted
+{
+    static inline std::atomic<long> built_left = 0;
+    static inline std::atomic<long> alive = 0;
+
+    long value = 0;
+
+    counted(long value) : value{ value }
+    {
+        if (built_left-- == 0)
+        {
+            throw 0;
+        }
+        ++alive;
+    };
+    counted(const counted& other) : counted{ other.value } {};
+    ~counted() { --alive; };
+};
+
+TEST(DynamicBuffer, ParallelConstruction)
+{
+    const std::size_t size = dynamic_buffer<int>::parallel_grain * 5 + 3;
+
+    dynamic_buffer<int> buffer1{ parallel_t{ 4 }, size, 7 };
+    EXPECT_EQ(buffer1.size, size);
+    EXPECT_TRUE(std::all_of(buffer1.begin(), buffer1.end(), [](int value) { return value == 7; }));
+
+    dynamic_buffer<int> buffer2{ parallel, size };
+    EXPECT_TRUE(std::all_of(buffer2.begin(), buffer2.end(), [](int value) { return value == 0; }));
+
+    dynamic_buffer<int> buffer3{ parallel_t{ 3 }, buffer1 };
+    EXPECT_EQ(buffer3, buffer1);
+
+    dynamic_buffer<std::string> strings{ parallel_t{ 4 }, dynamic_buffer<std::string>::parallel_grain * 2, "parallel" };
+    EXPECT_EQ(strings[strings.size - 1], "parallel");
+};
+
+TEST(DynamicBuffer, ParallelConstructionFailure)
+{
+    const std::size_t size = dynamic_buffer<counted>::parallel_grain * 4;
+
+    counted::built_left = static_cast<long>(size - 10);
+    EXPECT_THROW((dynamic_buffer<counted>{ parallel_t{ 4 }, size, 1 }), int);
+    EXPECT_EQ(counted::alive, 0);
+
+    counted::built_left = static_cast<long>(size);
+    dynamic_buffer<counted> buffer{ parallel_t{ 4 }, size, 1 };
+    counted::built_left = static_cast<long>(size / 2);
+    EXPECT_THROW((dynamic_buffer<counted>{ parallel_t{ 4 }, buffer }), int);
+    EXPECT_EQ(counted::alive, static_cast<long>(size));
+
+    counted::built_left = static_cast<long>(size / 2);
+    EXPECT_THROW(buffer.resize(parallel_t{ 4 }, size * 2, 2), int);
+    EXPECT_EQ(buffer.size, size);
+    EXPECT_EQ(counted::alive, static_cast<long>(size));
+};
+
+TEST(DynamicBuffer, ParallelResize)
+{
+    const std::size_t size = dynamic_buffer<int>::parallel_grain * 3;
+
+    dynamic_buffer<int> buffer(10, 1);
+    buffer.resize(parallel_t{ 4 }, size, 2);
+    EXPECT_EQ(buffer.size, size);
+    EXPECT_EQ(buffer[9], 1);
+    EXPECT_EQ(buffer[10], 2);
+    EXPECT_EQ(buffer[size - 1], 2);
+
+    buffer.resize(parallel_t{ 4 }, size * 2, buffer[0]);
+    EXPECT_EQ(buffer[size - 1], 2);
+    EXPECT_EQ(buffer[size], 1);
+    EXPECT_EQ(buffer[size * 2 - 1], 1);
+
+    buffer.resize(parallel_t{ 4 }, 5);
+    EXPECT_EQ(buffer.size, 5);
+
+    dynamic_buffer<std::string> strings(2, "kept");
+    strings.resize(parallel_t{ 2 }, dynamic_buffer<std::string>::parallel_grain * 3, "added");
+    EXPECT_EQ(strings[1], "kept");
+    EXPECT_EQ(strings[2], "added");
+};
+
+TEST(DynamicBuffer, GeneratorConstruction)
+{
+    dynamic_buffer<std::size_t> squares(from_generator, 100, [](std::size_t i) { return i * i; });
+    EXPECT_EQ(squares.size, 100);
+    for (std::size_t i = 0; i < squares.size; ++i)
+    {
+        EXPECT_EQ(squares[i], i * i);
+    }
+
+    dynamic_buffer<std::string> strings(from_generator, 3, [](std::size_t i) { return std::string(i + 1, 'x'); });
+    EXPECT_EQ(strings[0], "x");
+    EXPECT_EQ(strings[2], "xxx");
+
+    // every element is built once, straight from what the generator returns.
+    counted::built_left = 10;
+    {
+        dynamic_buffer<counted> built(from_generator, 10, [](std::size_t i) { return static_cast<long>(i); });
+        EXPECT_EQ(counted::alive, 10);
+        EXPECT_EQ(built[9].value, 9);
+    }
+
+    counted::built_left = 5;
+    EXPECT_THROW((dynamic_buffer<counted>(from_generator, 10, [](std::size_t i) { return static_cast<long>(i); })), int);
+    EXPECT_EQ(counted::alive, 0);
+
+    dynamic_buffer<int> empty(from_generator, 0, [](std::size_t) { return 1; });
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.data, nullptr);
+};
+
+TEST(DynamicBuffer, OutputConstruction)
+{
+    static_assert(std::output_iterator<dynamic_buffer<int>::construct_iterator, int>);
+
+    const std::vector<int> source = { 5, 6, 7 };
+    dynamic_buffer<int> copied(from_output, 10, [&](auto out) { std::copy(source.begin(), source.end(), out); });
+    EXPECT_EQ(copied.size, 3);
+    EXPECT_GE(copied.capacity, 10);
+    EXPECT_EQ(copied, (dynamic_buffer<int>{ 5, 6, 7 }));
+
+    dynamic_buffer<std::string> strings(from_output, 4, [](auto out)
+    {
+        *out++ = "first";
+        out.emplace(3, 'y');
+        *out = std::string{ "third" };
+    });
+    EXPECT_EQ(strings.size, 3);
+    EXPECT_EQ(strings[0], "first");
+    EXPECT_EQ(strings[1], "yyy");
+    EXPECT_EQ(strings[2], "third");
+
+    counted::built_left = 2;
+    EXPECT_THROW((dynamic_buffer<counted>(from_output, 4, [](auto out)
+    {
+        for (long i = 0; i < 4; ++i)
+        {
+            out.emplace(i);
+        }
+    })), int);
+    EXPECT_EQ(counted::alive, 0);
+
+    EXPECT_THROW((dynamic_buffer<std::string>(from_output, 2, [](auto out)
+    {
+        for (;;)
+        {
+            *out++ = "overrun";
+        }
+    })), std::length_error);
+};
+
+TEST(DynamicBuffer, ResizeAndOverwrite)
+{
+    dynamic_buffer<char> buffer = { 'a', 'b' };
+    buffer.resize_and_overwrite(100, [](char* data, std::size_t count)
+    {
+        EXPECT_EQ(count, 100);
+        EXPECT_EQ(data[1], 'b');
+        std::fill_n(data + 2, 8, 'c');
+        return std::size_t{ 10 };
+    });
+    EXPECT_EQ(buffer.size, 10);
+    EXPECT_GE(buffer.capacity, 100);
+    EXPECT_EQ(buffer[0], 'a');
+    EXPECT_EQ(buffer[9], 'c');
+
+    // shrinking only hands out the slots that are kept.
+    buffer.resize_and_overwrite(4, [](char* data, std::size_t count)
+    {
+        data[3] = 'd';
+        return count;
+    });
+    EXPECT_EQ(buffer.size, 4);
+    EXPECT_EQ(buffer[2], 'c');
+    EXPECT_EQ(buffer[3], 'd');
+
+    EXPECT_THROW(buffer.resize_and_overwrite(50, [](char*, std::size_t) -> std::size_t { throw 0; }), int);
+    EXPECT_EQ(buffer.size, 4);
+    EXPECT_EQ(buffer[3], 'd');
+
+    EXPECT_THROW(buffer.resize_and_overwrite(8, [](char*, std::size_t count) { return count + 1; }), std::length_error);
+    EXPECT_EQ(buffer.size, 4);
+};
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include "containers/dynamic_buffer.hpp"
+
+TEST(ElementCompare, Traits)
+{
+    static_assert(is_bitwise_comparable_v<int>);
+    static_assert(is_bitwise_comparable_v<std::byte>);
+    static_assert(is_bitwise_comparable_v<int*>);
+    static_assert(not is_bitwise_comparable_v<float>);
+    static_assert(not is_bitwise_comparable_v<std::string>);
+
+    static_assert(is_bytewise_ordered_v<unsigned char>);
+    static_assert(is_bytewise_ordered_v<std::byte>);
+    static_assert(is_bytewise_ordered_v<char8_t>);
+    static_assert(not is_bytewise_ordered_v<signed char>);
+    static_assert(not is_bytewise_ordered_v<unsigned int>);
+};
+
+TEST(ElementCompare, Mismatch)
+{
+    dynamic_buffer<int> buffer1(10000, 7);
+    dynamic_buffer<int> buffer2{ buffer1 };
+    EXPECT_EQ(mismatch_elements(buffer1.data, buffer2.data, buffer1.size), 10000);
+
+    buffer2[9999] = 8;
+    EXPECT_EQ(mismatch_elements(buffer1.data, buffer2.data, buffer1.size), 9999);
+
+    buffer2[300] = 8;
+    EXPECT_EQ(mismatch_elements(buffer1.data, buffer2.data, buffer1.size), 300);
+};
+
+TEST(ElementCompare, Bytes)
+{
+    dynamic_buffer<unsigned char> buffer1(5000, 10);
+    dynamic_buffer<unsigned char> buffer2{ buffer1 };
+    EXPECT_EQ(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::equivalent);
+
+    buffer2[4000] = 200;
+    EXPECT_NE(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+
+    buffer1.resize(4000);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+    EXPECT_EQ(buffer2 <=> buffer1, std::partial_ordering::greater);
+};
+
+TEST(ElementCompare, SignedIntegers)
+{
+    dynamic_buffer<int> buffer1(2000, 0);
+    dynamic_buffer<int> buffer2{ buffer1 };
+    buffer1[1500] = -1;
+    buffer2[1500] = 256;
+
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+    EXPECT_EQ(buffer2 <=> buffer1, std::partial_ordering::greater);
+};
+
+TEST(ElementCompare, FloatingPoint)
+{
+    dynamic_buffer<double> buffer1 = { 0.0, 1.0, 2.0 };
+    dynamic_buffer<double> buffer2 = { -0.0, 1.0, 2.0 };
+    EXPECT_EQ(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::equivalent);
+
+    buffer2[1] = std::nan("");
+    EXPECT_NE(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::unordered);
+};
+
+TEST(ElementCompare, NonTrivial)
+{
+    dynamic_buffer<std::string> buffer1 = { "a", "b", "c" };
+    dynamic_buffer<std::string> buffer2 = { "a", "b", "d" };
+    EXPECT_NE(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+};
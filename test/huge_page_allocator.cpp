@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "containers/huge_page_allocator.hpp"
+
+TEST(HugePageAllocator, SmallBlocks)
+{
+    huge_page_allocator<int> allocator{};
+    static_assert(not huge_page_allocator<int>::is_mapped(16));
+
+    auto [data, count] = allocator.allocate_at_least(16);
+    EXPECT_EQ(count, 16);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % 64, 0);
+    allocator.deallocate(data, count);
+};
+
+#if CONTAINERS_HAS_MMAN
+TEST(HugePageAllocator, MappedBlocks)
+{
+    huge_page_allocator<int> allocator{};
+    const std::size_t request = (std::size_t{ 3 } << 20) / sizeof(int);
+    EXPECT_TRUE(huge_page_allocator<int>::is_mapped(request));
+
+    auto [data, count] = allocator.allocate_at_least(request);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % huge_page_allocator<int>::huge_page_size, 0);
+    EXPECT_EQ(count * sizeof(int), std::size_t{ 4 } << 20);
+
+    data[0] = 1;
+    data[count - 1] = 2;
+    allocator.deallocate(data, count);
+};
+
+TEST(HugePageAllocator, ReallocateKeepsAlignment)
+{
+    huge_page_allocator<int> allocator{};
+    const std::size_t request = (std::size_t{ 2 } << 20) / sizeof(int);
+
+    auto [data, count] = allocator.allocate_at_least(request);
+    data[count - 1] = 3;
+    // a page mapped right after the block keeps it from growing in place, so it has to move.
+    void* blocker = ::mmap(data + count, 4096, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    ASSERT_NE(blocker, MAP_FAILED);
+
+    auto [new_data, new_count] = allocator.reallocate(data, count, request * 8);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(new_data) % huge_page_allocator<int>::huge_page_size, 0);
+    EXPECT_EQ(new_data[count - 1], 3);
+
+    allocator.deallocate(new_data, new_count);
+    ::munmap(blocker, 4096);
+};
+
+TEST(HugePageBuffer, Resize)
+{
+    const std::size_t size = (std::size_t{ 3 } << 20) / sizeof(int);
+    huge_page_buffer<int> buffer(size, 7);
+    EXPECT_GE(buffer.capacity, size);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data) % huge_page_allocator<int>::huge_page_size, 0);
+
+    buffer.resize(size * 4, 9);
+    EXPECT_GE(buffer.capacity, size * 4);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buffer.data) % huge_page_allocator<int>::huge_page_size, 0);
+    EXPECT_EQ(buffer[0], 7);
+    EXPECT_EQ(buffer[size - 1], 7);
+    EXPECT_EQ(buffer[size], 9);
+    EXPECT_EQ(buffer[size * 4 - 1], 9);
+
+    buffer.resize(10);
+    buffer.shrink_to_fit();
+    EXPECT_EQ(buffer.capacity, 10);
+    EXPECT_EQ(buffer[9], 7);
+};
+#endif
@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "containers/instrumented_allocator.hpp"
+#include "containers/realloc_allocator.hpp"
+
+namespace
+{
+    // every test counts its own type, the counts are kept for the whole process.
+    struct counted_block { int value = 0; };
+    struct counted_resize { int value = 0; };
+    struct counted_copy { int value = 0; };
+    struct counted_thread { int value = 0; };
+    struct counted_realloc { int value = 0; };
+    struct counted_report { int value = 0; };
+
+    struct throwing_move
+    {
+        int value = 0;
+
+        throwing_move() = default;
+        throwing_move(const throwing_move&) = default;
+        throwing_move(throwing_move&& other) noexcept(false) : value{ other.value } {};
+    };
+
+    template <typename A>
+    concept reallocating = requires (A& allocator) { allocator.reallocate(nullptr, 0, 0); };
+
+    template <typename T>
+    auto summary_of() -> allocation_summary
+    {
+        const std::string name = allocation_stats::type_name(typeid(T));
+        for (allocation_summary& summary : allocation_report())
+        {
+            if (summary.type == name)
+            {
+                return summary;
+            }
+        }
+        return {};
+    };
+};
+
+TEST(InstrumentedAllocator, Allocations)
+{
+    {
+        instrumented_buffer<counted_block> small(4);
+        instrumented_buffer<counted_block> large(1000);
+        const allocation_summary summary = summary_of<counted_block>();
+        EXPECT_EQ(summary.element_size, sizeof(counted_block));
+        EXPECT_EQ(summary.allocations, 2);
+        EXPECT_EQ(summary.deallocations, 0);
+        EXPECT_EQ(summary.bytes_allocated, 1004 * sizeof(counted_block));
+        EXPECT_EQ(summary.live_bytes, 1004 * sizeof(counted_block));
+        EXPECT_EQ(summary.sizes[allocation_summary::bucket_of(4 * sizeof(counted_block))], 1);
+        EXPECT_EQ(summary.sizes[allocation_summary::bucket_of(1000 * sizeof(counted_block))], 1);
+    }
+
+    const allocation_summary summary = summary_of<counted_block>();
+    EXPECT_EQ(summary.deallocations, 2);
+    EXPECT_EQ(summary.live_bytes, 0);
+    EXPECT_EQ(summary.peak_live_bytes, 1004 * sizeof(counted_block));
+
+    EXPECT_EQ(allocation_summary::bucket_of(0), 0);
+    EXPECT_EQ(allocation_summary::bucket_of(1), 0);
+    EXPECT_EQ(allocation_summary::bucket_of(64), 6);
+    EXPECT_EQ(allocation_summary::bucket_of(65), 7);
+};
+
+TEST(InstrumentedAllocator, Resize)
+{
+    instrumented_buffer<counted_resize> buffer(10);
+    buffer.resize(5);
+    buffer.resize(10);
+    EXPECT_EQ(summary_of<counted_resize>().reallocations, 0);
+
+    buffer.resize(100);
+    buffer.resize(1000, counted_resize{ 1 });
+    const allocation_summary summary = summary_of<counted_resize>();
+    EXPECT_EQ(summary.allocations, 3);
+    EXPECT_EQ(summary.deallocations, 2);
+    EXPECT_EQ(summary.reallocations, 2);
+    EXPECT_EQ(summary.moves, 110);
+    EXPECT_EQ(summary.copies, 0);
+};
+
+TEST(InstrumentedAllocator, CopiesAndMoves)
+{
+    const instrumented_buffer<counted_copy> buffer(8);
+    instrumented_buffer<counted_copy> copy{ buffer };
+    instrumented_buffer<counted_copy> moved{ std::move(copy) };
+    EXPECT_EQ(summary_of<counted_copy>().copies, 8);
+    EXPECT_EQ(summary_of<counted_copy>().moves, 0);
+
+    instrumented_buffer<throwing_move> throwing(4);
+    throwing.resize(100);
+    EXPECT_EQ(summary_of<throwing_move>().copies, 4);
+    EXPECT_EQ(summary_of<throwing_move>().moves, 0);
+};
+
+TEST(InstrumentedAllocator, Threads)
+{
+    instrumented_buffer<counted_thread> kept;
+    std::thread other{ [&]
+    {
+        instrumented_buffer<counted_thread> dropped(16);
+        kept = instrumented_buffer<counted_thread>(32);
+    } };
+    other.join();
+
+    // the other thread's counts outlive it.
+    allocation_summary summary = summary_of<counted_thread>();
+    EXPECT_EQ(summary.allocations, 2);
+    EXPECT_EQ(summary.deallocations, 1);
+    EXPECT_EQ(summary.live_bytes, 32 * sizeof(counted_thread));
+
+    kept.release_storage();
+    summary = summary_of<counted_thread>();
+    EXPECT_EQ(summary.deallocations, 2);
+    EXPECT_EQ(summary.live_bytes, 0);
+};
+
+TEST(InstrumentedAllocator, Upstream)
+{
+    static_assert(reallocating<instrumented_allocator<counted_realloc, realloc_allocator<counted_realloc>>>);
+    static_assert(not reallocating<instrumented_allocator<counted_realloc>>);
+
+    instrumented_buffer<counted_realloc, realloc_allocator<counted_realloc>> buffer(4);
+    buffer[3].value = 3;
+    buffer.resize(100000);
+    EXPECT_EQ(buffer[3].value, 3);
+
+    const allocation_summary summary = summary_of<counted_realloc>();
+    EXPECT_EQ(summary.reallocations, 1);
+    EXPECT_EQ(summary.moves, 4);
+    EXPECT_EQ(summary.allocations, 2);
+    EXPECT_EQ(summary.deallocations, 1);
+    EXPECT_EQ(static_cast<std::size_t>(summary.live_bytes), buffer.capacity * sizeof(counted_realloc));
+};
+
+TEST(InstrumentedAllocator, Reports)
+{
+    const instrumented_buffer<counted_report> buffer(16);
+
+    const std::string json = allocation_report_json(allocation_report());
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    const std::string name = allocation_stats::type_name(typeid(counted_report));
+    EXPECT_NE(json.find("{\"type\":\"" + name + "\",\"element_size\":4,\"allocations\":1,\"deallocations\":0,"), std::string::npos);
+    EXPECT_NE(json.find("\"sizes\":{\"64\":1}"), std::string::npos);
+
+    std::vector<std::vector<allocation_summary>> reports;
+    {
+        allocation_reporter reporter{ std::chrono::milliseconds{ 1 }, [&](std::vector<allocation_summary> report) { reports.push_back(std::move(report)); } };
+        std::this_thread::sleep_for(std::chrono::milliseconds{ 20 });
+    }
+    EXPECT_GE(reports.size(), 2);
+
+    log_allocation_report(reports.back());
+};
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <vector>
+#include "containers/mapped_buffer.hpp"
+
+#if CONTAINERS_HAS_MMAN
+namespace
+{
+    auto write_file(const std::filesystem::path& path, const std::vector<std::uint32_t>& values) -> void
+    {
+        std::ofstream file{ path, std::ios::binary | std::ios::trunc };
+        file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(std::uint32_t));
+    };
+
+    auto temporary_file(const char* name) -> std::filesystem::path
+    {
+        return std::filesystem::temp_directory_path() / name;
+    };
+};
+
+TEST(MappedBuffer, ReadOnly)
+{
+    const auto path = temporary_file("containers_mapped_read_only.bin");
+    write_file(path, { 1, 2, 3, 4, 5 });
+
+    mapped_buffer<const std::uint32_t> buffer{ path };
+    static_assert(std::same_as<decltype(buffer[0]), const std::uint32_t&>);
+    static_assert(std::same_as<decltype(*buffer.begin()), const std::uint32_t&>);
+    EXPECT_EQ(buffer.mode, map_mode::read_only);
+    EXPECT_EQ(buffer.size, 5);
+    EXPECT_EQ(buffer[0], 1);
+    EXPECT_EQ(buffer[4], 5);
+    EXPECT_TRUE(std::ranges::equal(buffer, std::vector<std::uint32_t>{ 1, 2, 3, 4, 5 }));
+    buffer.advise(access_hint::sequential);
+    buffer.advise(access_hint::random, 1, 3);
+
+    // mutable elements cannot be mapped read only, and default to copy on write.
+    EXPECT_THROW((mapped_buffer<std::uint32_t>{ path, map_mode::read_only }), std::invalid_argument);
+    EXPECT_EQ(mapped_buffer<std::uint32_t>{ path }.mode, map_mode::copy_on_write);
+
+    std::filesystem::remove(path);
+};
+
+TEST(MappedBuffer, CopyOnWrite)
+{
+    const auto path = temporary_file("containers_mapped_copy_on_write.bin");
+    write_file(path, { 1, 2, 3 });
+
+    {
+        mapped_buffer<std::uint32_t> buffer{ path, map_mode::copy_on_write };
+        buffer[1] = 20;
+        EXPECT_THROW(buffer.advise(access_hint::dont_need), std::invalid_argument);
+        EXPECT_EQ(buffer[1], 20);
+    }
+
+    const mapped_buffer<std::uint32_t> buffer{ path };
+    EXPECT_EQ(buffer[1], 2);
+
+    std::filesystem::remove(path);
+};
+
+TEST(MappedBuffer, Shared)
+{
+    const auto path = temporary_file("containers_mapped_shared.bin");
+    write_file(path, { 1, 2, 3 });
+
+    {
+        mapped_buffer<std::uint32_t> buffer{ path, map_mode::shared };
+        buffer[1] = 20;
+        buffer.sync();
+    }
+
+    const mapped_buffer<std::uint32_t> buffer{ path };
+    EXPECT_EQ(buffer[1], 20);
+
+    std::filesystem::remove(path);
+};
+
+TEST(MappedBuffer, MoveAndEmpty)
+{
+    const auto path = temporary_file("containers_mapped_move.bin");
+    write_file(path, {});
+
+    mapped_buffer<std::uint32_t> empty{ path };
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.data, nullptr);
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    write_file(path, { 7, 8 });
+    mapped_buffer<std::uint32_t> buffer1{ path };
+    mapped_buffer<std::uint32_t> buffer2{ std::move(buffer1) };
+    EXPECT_EQ(buffer1.data, nullptr);
+    EXPECT_EQ(buffer2[1], 8);
+
+    empty = std::move(buffer2);
+    EXPECT_EQ(empty[0], 7);
+
+    std::filesystem::remove(path);
+};
+
+TEST(MappedBuffer, MissingFile)
+{
+    EXPECT_THROW(mapped_buffer<std::uint32_t>{ temporary_file("containers_mapped_missing.bin") }, std::system_error);
+};
+#endif
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include "containers/matrix_buffer.hpp"
+
+TEST(MatrixBuffer, DynamicBufferView)
+{
+    dynamic_buffer<int> buffer(12);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    auto view = as_mdspan(buffer, 3, 4);
+    EXPECT_EQ(view.extent(0), 3);
+    EXPECT_EQ(view.extent(1), 4);
+    for (std::size_t row = 0; row < 3; ++row)
+    {
+        for (std::size_t column = 0; column < 4; ++column)
+        {
+            EXPECT_EQ((view[row, column]), row * 4 + column);
+        }
+    }
+
+    view[2, 1] = -1;
+    EXPECT_EQ(buffer[9], -1);
+
+    const auto& constant = buffer;
+    auto cube = as_mdspan(constant, std::extents<std::size_t, 2, 3, 2>{});
+    static_assert(std::is_same_v<decltype(cube)::element_type, const int>);
+    EXPECT_EQ((cube[1, 2, 1]), 11);
+};
+
+TEST(MatrixBuffer, StaticBufferView)
+{
+    static_buffer<float, 6> heap{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+    inline_buffer<float, 6> local{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f };
+
+    auto heap_view = as_mdspan(heap, 2, 3);
+    auto local_view = as_mdspan(local, 2, 3);
+    EXPECT_EQ((heap_view[1, 0]), 4.0f);
+    EXPECT_EQ((local_view[1, 2]), 6.0f);
+};
+
+template <typename Mapping>
+static auto expect_unique_within_span(const Mapping& mapping) -> void
+{
+    std::set<std::size_t> offsets;
+    for (std::size_t row = 0; row < mapping.extents().extent(0); ++row)
+    {
+        for (std::size_t column = 0; column < mapping.extents().extent(1); ++column)
+        {
+            const std::size_t offset = mapping(row, column);
+            EXPECT_LT(offset, mapping.required_span_size());
+            EXPECT_TRUE(offsets.insert(offset).second);
+        }
+    }
+};
+
+TEST(MatrixBuffer, TiledLayout)
+{
+    using mapping = layout_tiled<4, 2>::mapping<std::dextents<std::size_t, 2>>;
+
+    const mapping exact{ std::dextents<std::size_t, 2>{ 8, 4 } };
+    EXPECT_EQ(exact.required_span_size(), 32);
+    EXPECT_TRUE(exact.is_exhaustive());
+    EXPECT_EQ(exact(0, 1), 1);
+    EXPECT_EQ(exact(1, 0), 2);
+    EXPECT_EQ(exact(0, 2), 8);
+    EXPECT_EQ(exact(4, 0), 16);
+    expect_unique_within_span(exact);
+
+    const mapping padded{ std::dextents<std::size_t, 2>{ 5, 3 } };
+    EXPECT_EQ(padded.required_span_size(), 32);
+    EXPECT_FALSE(padded.is_exhaustive());
+    expect_unique_within_span(padded);
+};
+
+TEST(MatrixBuffer, MortonLayout)
+{
+    using mapping = layout_morton::mapping<std::dextents<std::size_t, 2>>;
+
+    const mapping square{ std::dextents<std::size_t, 2>{ 4, 4 } };
+    EXPECT_EQ(square.required_span_size(), 16);
+    EXPECT_EQ(square(0, 1), 1);
+    EXPECT_EQ(square(1, 0), 2);
+    EXPECT_EQ(square(1, 1), 3);
+    EXPECT_EQ(square(0, 2), 4);
+    EXPECT_EQ(square(2, 0), 8);
+    EXPECT_EQ(square(3, 3), 15);
+    expect_unique_within_span(square);
+
+    const mapping wide{ std::dextents<std::size_t, 2>{ 3, 10 } };
+    EXPECT_EQ(wide.required_span_size(), 64);
+    EXPECT_FALSE(wide.is_exhaustive());
+    EXPECT_EQ(wide(0, 4), 16);
+    expect_unique_within_span(wide);
+
+    const mapping tall{ std::dextents<std::size_t, 2>{ 7, 2 } };
+    EXPECT_EQ(tall.required_span_size(), 16);
+    EXPECT_EQ(tall(2, 0), 4);
+    expect_unique_within_span(tall);
+
+    const mapping empty{ std::dextents<std::size_t, 2>{ 0, 5 } };
+    EXPECT_EQ(empty.required_span_size(), 0);
+};
+
+template <typename Source, typename Destination>
+static auto transpose(Source source, Destination destination) -> void
+{
+    for (std::size_t row = 0; row < source.extent(0); ++row)
+    {
+        for (std::size_t column = 0; column < source.extent(1); ++column)
+        {
+            destination[column, row] = source[row, column];
+        }
+    }
+};
+
+template <typename Matrix>
+static auto check_matrix() -> void
+{
+    Matrix matrix(5, 7);
+    EXPECT_EQ(matrix.rows(), 5);
+    EXPECT_EQ(matrix.columns(), 7);
+    EXPECT_EQ(matrix.storage.size, matrix.mapping.required_span_size());
+
+    for (std::size_t row = 0; row < 5; ++row)
+    {
+        for (std::size_t column = 0; column < 7; ++column)
+        {
+            matrix[row, column] = static_cast<int>(row * 7 + column);
+        }
+    }
+
+    Matrix transposed(7, 5);
+    transpose(std::as_const(matrix).view(), transposed.view());
+    for (std::size_t row = 0; row < 5; ++row)
+    {
+        for (std::size_t column = 0; column < 7; ++column)
+        {
+            EXPECT_EQ((transposed[column, row]), row * 7 + column);
+        }
+    }
+
+    Matrix copy{ matrix };
+    EXPECT_EQ(copy, matrix);
+};
+
+TEST(MatrixBuffer, OwningMatrix)
+{
+    check_matrix<matrix_buffer<int>>();
+    check_matrix<tiled_matrix_buffer<int, 4>>();
+    check_matrix<morton_matrix_buffer<int>>();
+
+    matrix_buffer<int> filled(2, 2, 9);
+    EXPECT_TRUE(std::ranges::all_of(filled.storage, [](int value) { return value == 9; }));
+};
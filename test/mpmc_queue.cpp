@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "containers/mpmc_queue.hpp"
+
+TEST(MpmcQueue, Capacity)
+{
+    EXPECT_EQ(mpmc_queue<int>{ 1 }.capacity(), 2);
+    EXPECT_EQ(mpmc_queue<int>{ 5 }.capacity(), 8);
+
+    mpmc_queue<int> queue{ 4 };
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(queue.slots.data) % mpmc_queue<int>::cache_line, 0);
+    EXPECT_EQ(sizeof(mpmc_queue<int>::slot), mpmc_queue<int>::cache_line);
+};
+
+TEST(MpmcQueue, TryPushAndPop)
+{
+    mpmc_queue<int> queue{ 4 };
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+    }
+    EXPECT_FALSE(queue.try_push(4));
+    EXPECT_EQ(queue.size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(queue.try_pop(value));
+
+    // wrap around several times.
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(queue.try_push(i));
+        EXPECT_TRUE(queue.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+};
+
+TEST(MpmcQueue, NonTrivialElements)
+{
+    auto shared = std::make_shared<int>(1);
+    {
+        mpmc_queue<std::shared_ptr<int>> queue{ 4 };
+        queue.try_push(shared);
+        queue.push(shared);
+        EXPECT_EQ(shared.use_count(), 3);
+
+        std::shared_ptr<int> value = queue.pop();
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+
+    mpmc_queue<std::string> strings{ 2 };
+    strings.push(20, 'a');
+    EXPECT_EQ(strings.pop(), std::string(20, 'a'));
+};
+
+TEST(MpmcQueue, Blocking)
+{
+    mpmc_queue<int> queue{ 2 };
+    std::thread consumer{ [&]
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            EXPECT_EQ(queue.pop(), i);
+        }
+    } };
+    for (int i = 0; i < 1000; ++i)
+    {
+        queue.push(i);
+    }
+    consumer.join();
+    EXPECT_EQ(queue.size(), 0);
+};
+
+TEST(MpmcQueue, ManyProducersAndConsumers)
+{
+    constexpr int threads = 4;
+    constexpr std::uint64_t per_thread = 20'000;
+    mpmc_queue<std::uint64_t> queue{ 64 };
+    std::atomic<std::uint64_t> sum = 0;
+
+    std::vector<std::thread> workers{};
+    for (int t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&, t]
+        {
+            for (std::uint64_t i = 1; i <= per_thread; ++i)
+            {
+                if (t % 2 == 0)
+                {
+                    queue.push(i);
+                }
+                else
+                {
+                    while (not queue.try_push(i))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+        workers.emplace_back([&, t]
+        {
+            std::uint64_t local = 0;
+            for (std::uint64_t i = 0; i < per_thread; ++i)
+            {
+                std::uint64_t value = 0;
+                if (t % 2 == 0)
+                {
+                    value = queue.pop();
+                }
+                else
+                {
+                    while (not queue.try_pop(value))
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                local += value;
+            }
+            sum += local;
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(sum, threads * per_thread * (per_thread + 1) / 2);
+    EXPECT_EQ(queue.size(), 0);
+};
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/pool_allocator.hpp"
+
+TEST(PoolAllocator, SizeClasses)
+{
+    static_assert(size_class_pool::class_of(0) == 0);
+    static_assert(size_class_pool::class_of(16) == 0);
+    static_assert(size_class_pool::class_of(17) == 1);
+    static_assert(size_class_pool::class_of(64) == 2);
+    static_assert(size_class_pool::class_of(size_class_pool::max_block) == size_class_pool::class_count - 1);
+    static_assert(size_class_pool::block_size(size_class_pool::class_count - 1) == size_class_pool::max_block);
+};
+
+TEST(PoolAllocator, AllocateAtLeast)
+{
+    pool_allocator<int> allocator{};
+
+    auto [data1, count1] = allocator.allocate_at_least(5);
+    EXPECT_EQ(count1, 8);
+    allocator.deallocate(data1, count1);
+
+    auto [data2, count2] = allocator.allocate_at_least(7);
+    EXPECT_EQ(data2, data1);
+    allocator.deallocate(data2, 7);
+
+    const std::size_t large = size_class_pool::max_block / sizeof(int) + 1;
+    auto [data3, count3] = allocator.allocate_at_least(large);
+    EXPECT_EQ(count3, large);
+    allocator.deallocate(data3, count3);
+};
+
+TEST(PoolAllocator, OddSizedElements)
+{
+    struct triple
+    {
+        int a, b, c;
+    };
+    pool_allocator<triple> allocator{};
+
+    for (std::size_t count : { 1, 2, 5, 100, 1000 })
+    {
+        auto [data, capacity] = allocator.allocate_at_least(count);
+        EXPECT_GE(capacity, count);
+        EXPECT_EQ(size_class_pool::class_of(capacity * sizeof(triple)), size_class_pool::class_of(count * sizeof(triple)));
+        allocator.deallocate(data, capacity);
+    }
+};
+
+TEST(PoolAllocator, BoundedRetention)
+{
+    pool_allocator<std::byte> allocator{};
+    const std::size_t index = size_class_pool::class_of(4096);
+
+    std::vector<std::byte*> blocks{};
+    for (std::size_t i = 0; i < 4 * size_class_pool::cache_limit(index); ++i)
+    {
+        blocks.push_back(allocator.allocate(4096));
+    }
+    for (std::byte* block : blocks)
+    {
+        allocator.deallocate(block, 4096);
+    }
+
+    EXPECT_LE(size_class_pool::local()->lists[index].count, size_class_pool::cache_limit(index));
+};
+
+TEST(PoolAllocator, CrossThread)
+{
+    pool_allocator<std::byte> allocator{};
+    std::vector<std::byte*> blocks(256);
+
+    std::thread producer{ [&]
+    {
+        for (std::byte*& block : blocks)
+        {
+            block = allocator.allocate(100);
+        }
+    } };
+    producer.join();
+
+    std::thread consumer{ [&]
+    {
+        for (std::byte* block : blocks)
+        {
+            allocator.deallocate(block, 100);
+        }
+    } };
+    consumer.join();
+};
+
+TEST(PoolBuffer, Churn)
+{
+    using buffer = dynamic_buffer<std::byte, pool_allocator<std::byte>>;
+    static_assert(buffer::is_bulk_copyable);
+
+    std::vector<std::thread> threads{};
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([]
+        {
+            for (std::size_t i = 0; i < 10000; ++i)
+            {
+                buffer message(64 << (i % 6), std::byte{ 1 });
+                buffer copy{ message };
+                copy.resize(copy.size * 2, std::byte{ 2 });
+                ASSERT_EQ(copy[0], std::byte{ 1 });
+                ASSERT_EQ(copy[copy.size - 1], std::byte{ 2 });
+            }
+        });
+    }
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+};
@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "containers/dynamic_buffer.hpp"
+#include "containers/realloc_allocator.hpp"
+
+TEST(ReallocAllocator, AllocateAtLeast)
+{
+    realloc_allocator<int> allocator{};
+    auto [data, count] = allocator.allocate_at_least(5);
+
+    EXPECT_NE(data, nullptr);
+    EXPECT_EQ(count, 5);
+
+    allocator.deallocate(data, count);
+};
+
+TEST(ReallocAllocator, Reallocate)
+{
+    realloc_allocator<int> allocator{};
+    int* data = allocator.allocate(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        data[i] = i;
+    }
+
+    auto [new_data, count] = allocator.reallocate(data, 4, 1000);
+    EXPECT_EQ(count, 1000);
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_EQ(new_data[i], i);
+    }
+
+    allocator.deallocate(new_data, count);
+};
+
+TEST(ReallocAllocator, DynamicBufferResize)
+{
+    static_assert(dynamic_buffer<int, realloc_allocator<int>>::is_bulk_relocatable);
+    dynamic_buffer<int, realloc_allocator<int>> buffer = { 0, 1, 2, 3, 4, 5 };
+    EXPECT_GE(buffer.capacity, 6);
+
+    buffer.resize(100000, buffer[5]);
+    EXPECT_EQ(buffer.size, 100000);
+    EXPECT_GE(buffer.capacity, 100000);
+    for (std::size_t i = 0; i < 6; ++i)
+    {
+        EXPECT_EQ(buffer[i], i);
+    }
+    EXPECT_EQ(buffer[99999], 5);
+
+    buffer.resize(uninitialized, 200000);
+    EXPECT_EQ(buffer[5], 5);
+
+    buffer.resize(3);
+    buffer.shrink_to_fit();
+    EXPECT_EQ(buffer.size, 3);
+    EXPECT_EQ(buffer[2], 2);
+};
+
+TEST(ReallocAllocator, NonTrivialElements)
+{
+    static_assert(not dynamic_buffer<std::string, realloc_allocator<std::string>>::is_bulk_relocatable);
+    dynamic_buffer<std::string, realloc_allocator<std::string>> buffer(2, "abc");
+
+    buffer.resize(50, "d");
+    EXPECT_EQ(buffer[1], "abc");
+    EXPECT_EQ(buffer[49], "d");
+};
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "containers/segmented_buffer.hpp"
+
+static_assert(std::random_access_iterator<segmented_buffer<int>::iterator>);
+static_assert(std::random_access_iterator<segmented_buffer<int>::const_iterator>);
+
+TEST(SegmentedBuffer, Construction)
+{
+    segmented_buffer<int, 4> empty{};
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.chunk_count(), 0);
+    EXPECT_EQ(empty.begin(), empty.end());
+
+    segmented_buffer<std::string, 4> filled(10, "abc");
+    EXPECT_EQ(filled.size, 10);
+    EXPECT_EQ(filled.chunk_count(), 3);
+    EXPECT_TRUE(std::all_of(filled.begin(), filled.end(), [](const std::string& value) { return value == "abc"; }));
+
+    static_assert(segmented_buffer<double>::chunk_size == 8192);
+    static_assert(segmented_buffer<char[3]>::chunk_size == 16384);
+};
+
+TEST(SegmentedBuffer, StableAddresses)
+{
+    segmented_buffer<int, 8> buffer(5);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    std::vector<int*> addresses;
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        addresses.push_back(&buffer[i]);
+    }
+
+    for (std::size_t size = 6; size < 200; size += 7)
+    {
+        buffer.resize(size, -1);
+        for (std::size_t i = 0; i < addresses.size(); ++i)
+        {
+            EXPECT_EQ(&buffer[i], addresses[i]);
+            EXPECT_EQ(buffer[i], static_cast<int>(i));
+        }
+    }
+    EXPECT_EQ(buffer[199 - 7], -1);
+
+    buffer.resize(3);
+    EXPECT_EQ(buffer.chunk_count(), 1);
+    EXPECT_EQ(&buffer[2], addresses[2]);
+    EXPECT_EQ(buffer.chunks[1], nullptr);
+
+    buffer.resize(0);
+    EXPECT_EQ(buffer.chunk_count(), 0);
+    EXPECT_EQ(buffer.chunks[0], nullptr);
+};
+
+TEST(SegmentedBuffer, Segments)
+{
+    segmented_buffer<int, 16> buffer(40, 1);
+
+    std::vector<std::size_t> sizes;
+    int total = 0;
+    for (std::span<int> segment : buffer.segments())
+    {
+        sizes.push_back(segment.size());
+        total = std::reduce(segment.begin(), segment.end(), total);
+    }
+    EXPECT_EQ(sizes, (std::vector<std::size_t>{ 16, 16, 8 }));
+    EXPECT_EQ(total, 40);
+
+    EXPECT_EQ(buffer.chunk(1).data(), &buffer[16]);
+    EXPECT_EQ(std::as_const(buffer).chunk(2).size(), 8);
+};
+
+TEST(SegmentedBuffer, Iteration)
+{
+    segmented_buffer<int, 4> buffer(11);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    EXPECT_EQ(buffer.end() - buffer.begin(), 11);
+    EXPECT_EQ(buffer.begin()[9], 9);
+    EXPECT_EQ(*(buffer.begin() + 4), 4);
+    EXPECT_EQ(*std::prev(buffer.end()), 10);
+    EXPECT_EQ(*buffer.rbegin(), 10);
+    EXPECT_EQ(std::accumulate(buffer.cbegin(), buffer.cend(), 0), 55);
+
+    std::reverse(buffer.begin(), buffer.end());
+    EXPECT_EQ(buffer[0], 10);
+    EXPECT_EQ(buffer[10], 0);
+
+    std::sort(buffer.begin(), buffer.end());
+    EXPECT_TRUE(std::is_sorted(buffer.cbegin(), buffer.cend()));
+};
+
+struct fragile
+{
+    static inline int live = 0;
+    static inline int fail_at = -1;
+
+    fragile()
+    {
+        if (live == fail_at)
+        {
+            throw std::runtime_error{ "fragile" };
+        }
+        ++live;
+    };
+    fragile(const fragile&) : fragile{} {};
+    ~fragile() { --live; };
+};
+
+TEST(SegmentedBuffer, ResizeFailure)
+{
+    {
+        segmented_buffer<fragile, 4> buffer(6);
+        fragile* kept = &buffer[5];
+
+        fragile::fail_at = 13;
+        EXPECT_THROW(buffer.resize(20), std::runtime_error);
+        EXPECT_EQ(buffer.size, 6);
+        EXPECT_EQ(buffer.chunk_count(), 2);
+        EXPECT_EQ(buffer.chunks[2], nullptr);
+        EXPECT_EQ(&buffer[5], kept);
+        EXPECT_EQ(fragile::live, 6);
+
+        fragile::fail_at = 8;
+        EXPECT_THROW((segmented_buffer<fragile, 4>{ buffer }), std::runtime_error);
+        EXPECT_EQ(fragile::live, 6);
+
+        fragile::fail_at = -1;
+        buffer.resize(20);
+        EXPECT_EQ(fragile::live, 20);
+    }
+    EXPECT_EQ(fragile::live, 0);
+};
+
+TEST(SegmentedBuffer, CopyAndMove)
+{
+    segmented_buffer<std::string, 2> buffer(5, "five");
+
+    segmented_buffer<std::string, 2> copy{ buffer };
+    EXPECT_EQ(copy, buffer);
+    copy[4] = "changed";
+    EXPECT_FALSE(copy == buffer);
+
+    segmented_buffer<std::string, 2> moved{ std::move(copy) };
+    EXPECT_EQ(moved.size, 5);
+    EXPECT_EQ(moved[4], "changed");
+    EXPECT_EQ(copy.size, 0);
+
+    buffer = moved;
+    EXPECT_EQ(buffer, moved);
+};
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "containers/shared_buffer.hpp"
+
+TEST(SharedBuffer, Freeze)
+{
+    dynamic_buffer<int> buffer(100);
+    std::iota(buffer.begin(), buffer.end(), 0);
+    const int* storage = buffer.data;
+
+    const shared_buffer<int> shared{ std::move(buffer) };
+    EXPECT_EQ(buffer.data, nullptr);
+    EXPECT_EQ(buffer.size, 0);
+    EXPECT_EQ(shared.data, storage);
+    EXPECT_EQ(shared.size, 100);
+    EXPECT_EQ(shared[42], 42);
+    EXPECT_EQ(shared.use_count(), 1);
+
+    const shared_buffer<int> empty{ dynamic_buffer<int>{} };
+    EXPECT_EQ(empty.block, nullptr);
+    EXPECT_TRUE(empty.empty());
+    EXPECT_EQ(empty.use_count(), 0);
+};
+
+TEST(SharedBuffer, CopyAndMove)
+{
+    shared_buffer<int> first{ dynamic_buffer<int>{ 1, 2, 3 } };
+    shared_buffer<int> second{ first };
+    EXPECT_EQ(first.use_count(), 2);
+    EXPECT_EQ(second.data, first.data);
+    EXPECT_EQ(first, second);
+
+    shared_buffer<int> third{ std::move(second) };
+    EXPECT_EQ(second.block, nullptr);
+    EXPECT_EQ(first.use_count(), 2);
+
+    third = shared_buffer<int>{};
+    EXPECT_EQ(first.use_count(), 1);
+
+    first.release();
+    EXPECT_TRUE(first.empty());
+    EXPECT_EQ(first.block, nullptr);
+};
+
+TEST(SharedBuffer, Slices)
+{
+    dynamic_buffer<int> buffer(10);
+    std::iota(buffer.begin(), buffer.end(), 0);
+
+    shared_buffer<int> middle;
+    {
+        const shared_buffer<int> whole{ std::move(buffer) };
+        middle = whole.slice(2, 6);
+        EXPECT_EQ(whole.use_count(), 2);
+        EXPECT_EQ(middle.data, whole.data + 2);
+    }
+    // the slice keeps the storage alive on its own.
+    EXPECT_EQ(middle.use_count(), 1);
+    EXPECT_TRUE(std::ranges::equal(middle, std::vector<int>{ 2, 3, 4, 5, 6, 7 }));
+
+    const shared_buffer<int> inner = middle.slice(1, 2);
+    EXPECT_TRUE(std::ranges::equal(inner, std::vector<int>{ 3, 4 }));
+    EXPECT_TRUE(std::ranges::equal(inner.as_span(), std::vector<int>{ 3, 4 }));
+    EXPECT_TRUE(middle.slice(6, 0).empty());
+
+    shared_buffer<int> moved = std::move(middle).slice(0, 1);
+    EXPECT_EQ(middle.block, nullptr);
+    EXPECT_EQ(moved.use_count(), 2);
+    EXPECT_EQ(moved[0], 2);
+};
+
+TEST(SharedBuffer, Thaw)
+{
+    dynamic_buffer<std::string> buffer = { "a", "b", "c", "d" };
+    const std::string* storage = buffer.data;
+
+    // the only owner gets the storage back as it was.
+    dynamic_buffer<std::string> thawed = shared_buffer<std::string>{ std::move(buffer) }.thaw();
+    EXPECT_EQ(thawed.data, storage);
+    EXPECT_EQ(thawed.size, 4);
+
+    // a unique slice keeps the storage, with its elements moved to the front.
+    shared_buffer<std::string> slice = shared_buffer<std::string>{ std::move(thawed) }.slice(1, 2);
+    dynamic_buffer<std::string> front = std::move(slice).thaw();
+    EXPECT_EQ(front.data, storage);
+    EXPECT_EQ(front, (dynamic_buffer<std::string>{ "b", "c" }));
+    EXPECT_EQ(slice.block, nullptr);
+
+    // a shared one is copied, and the other owners are untouched.
+    shared_buffer<std::string> shared{ std::move(front) };
+    shared_buffer<std::string> other{ shared };
+    dynamic_buffer<std::string> copy = std::move(shared).slice(1, 1).thaw();
+    EXPECT_NE(copy.data, storage);
+    EXPECT_EQ(copy, (dynamic_buffer<std::string>{ "c" }));
+    EXPECT_EQ(other.use_count(), 1);
+    EXPECT_EQ(other[0], "b");
+
+    copy[0] = "changed";
+    EXPECT_EQ(other[1], "c");
+
+    EXPECT_EQ(shared_buffer<int>{}.thaw().size, 0);
+};
+
+TEST(SharedBuffer, Threads)
+{
+    dynamic_buffer<long> buffer(100000);
+    std::iota(buffer.begin(), buffer.end(), 0l);
+    const shared_buffer<long> shared{ std::move(buffer) };
+    const long expected = 99999l * 100000l / 2;
+
+    std::vector<long> sums(4);
+    std::vector<std::thread> workers;
+    for (std::size_t i = 0; i < sums.size(); ++i)
+    {
+        workers.emplace_back([&sums, i, copy = shared]
+        {
+            for (int round = 0; round < 100; ++round)
+            {
+                const shared_buffer<long> half = copy.slice(round % 2 ? 0 : 50000, 50000);
+                sums[i] += std::accumulate(half.begin(), half.end(), 0l);
+            }
+        });
+    }
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    EXPECT_EQ(shared.use_count(), 1);
+    for (long sum : sums)
+    {
+        EXPECT_EQ(sum, 50 * expected);
+    }
+};
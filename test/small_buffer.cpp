@@ -0,0 +1,206 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <memory_resource>
+#include "containers/small_buffer.hpp"
+
+TEST(SmallBuffer, DefaultConstruction)
+{
+    small_buffer<int, 4> buffer{};
+
+    EXPECT_EQ(buffer.size, 0);
+    EXPECT_EQ(buffer.capacity, 4);
+    EXPECT_TRUE(buffer.is_inline());
+};
+
+TEST(SmallBuffer, InlineConstruction)
+{
+    small_buffer<int, 4> buffer1(4, 7);
+    EXPECT_TRUE(buffer1.is_inline());
+    EXPECT_EQ(buffer1.size, 4);
+    for (std::size_t i = 0; i < buffer1.size; ++i)
+    {
+        EXPECT_EQ(buffer1[i], 7);
+    }
+
+    small_buffer<int, 4> buffer2 = { 0, 1, 2 };
+    EXPECT_TRUE(buffer2.is_inline());
+    for (std::size_t i = 0; i < buffer2.size; ++i)
+    {
+        EXPECT_EQ(buffer2[i], i);
+    }
+};
+
+TEST(SmallBuffer, HeapConstruction)
+{
+    small_buffer<int, 4> buffer(5);
+    EXPECT_FALSE(buffer.is_inline());
+    EXPECT_EQ(buffer.size, 5);
+    EXPECT_GE(buffer.capacity, 5);
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        EXPECT_EQ(buffer[i], 0);
+    }
+};
+
+TEST(SmallBuffer, CopyConstruction)
+{
+    small_buffer<std::string, 2> buffer1 = { "a", "b" };
+    small_buffer<std::string, 2> buffer2{ buffer1 };
+    EXPECT_TRUE(buffer2.is_inline());
+    EXPECT_EQ(buffer2, buffer1);
+
+    small_buffer<std::string, 2> buffer3 = { "a", "b", "c" };
+    small_buffer<std::string, 2> buffer4{ buffer3 };
+    EXPECT_FALSE(buffer4.is_inline());
+    EXPECT_NE(buffer4.data, buffer3.data);
+    EXPECT_EQ(buffer4, buffer3);
+};
+
+TEST(SmallBuffer, MoveConstruction)
+{
+    small_buffer<std::string, 2> buffer1 = { "a", "b" };
+    small_buffer<std::string, 2> buffer2{ std::move(buffer1) };
+    EXPECT_EQ(buffer1.size, 0);
+    EXPECT_TRUE(buffer2.is_inline());
+    EXPECT_EQ(buffer2[1], "b");
+
+    small_buffer<std::string, 2> buffer3 = { "a", "b", "c" };
+    std::string* buffer3_data = buffer3.data;
+    small_buffer<std::string, 2> buffer4{ std::move(buffer3) };
+    EXPECT_EQ(buffer3.size, 0);
+    EXPECT_TRUE(buffer3.is_inline());
+    EXPECT_EQ(buffer4.data, buffer3_data);
+    EXPECT_EQ(buffer4[2], "c");
+};
+
+TEST(SmallBuffer, Assignment)
+{
+    small_buffer<int, 2> buffer1 = { 1, 2, 3 };
+    small_buffer<int, 2> buffer2 = { 4 };
+    buffer2 = buffer1;
+    EXPECT_EQ(buffer2, buffer1);
+
+    small_buffer<int, 2> buffer3 = { 5 };
+    buffer1 = buffer3;
+    EXPECT_EQ(buffer1, buffer3);
+    buffer1 = std::move(buffer2);
+    EXPECT_EQ(buffer1.size, 3);
+    EXPECT_EQ(buffer1[2], 3);
+};
+
+TEST(SmallBuffer, AllocatorAwareAssignment)
+{
+    using pmr_buffer = small_buffer<int, 2, std::pmr::polymorphic_allocator<int>>;
+    std::pmr::monotonic_buffer_resource resource1{};
+    std::pmr::monotonic_buffer_resource resource2{};
+
+    pmr_buffer buffer1{ std::allocator_arg, &resource1 };
+    pmr_buffer buffer2{ std::allocator_arg, &resource2 };
+    buffer2.resize(8, 5);
+    int* buffer2_data = buffer2.data;
+
+    buffer1 = std::move(buffer2);
+    EXPECT_EQ(buffer1.allocator.resource(), &resource1);
+    EXPECT_NE(buffer1.data, buffer2_data);
+    EXPECT_EQ(buffer1.size, 8);
+    EXPECT_EQ(buffer1[7], 5);
+    EXPECT_EQ(buffer2.size, 0);
+    EXPECT_TRUE(buffer2.is_inline());
+
+    pmr_buffer buffer3{ std::allocator_arg, &resource2 };
+    buffer3.resize(4, 6);
+    buffer1 = buffer3;
+    EXPECT_EQ(buffer1.allocator.resource(), &resource1);
+    EXPECT_EQ(buffer1, buffer3);
+
+    pmr_buffer buffer4{ std::allocator_arg, &resource1 };
+    buffer4.resize(6, 7);
+    int* buffer4_data = buffer4.data;
+    buffer1 = std::move(buffer4);
+    EXPECT_EQ(buffer1.data, buffer4_data);
+
+    // swapping may fall back on move assignment, which allocates between unequal resources.
+    static_assert(not noexcept(swap(buffer1, buffer2)));
+    static_assert(noexcept(swap(std::declval<small_buffer<int, 2>&>(), std::declval<small_buffer<int, 2>&>())));
+};
+
+TEST(SmallBuffer, Swap)
+{
+    small_buffer<int, 2> buffer1 = { 1 };
+    small_buffer<int, 2> buffer2 = { 2, 3, 4 };
+    int* buffer2_data = buffer2.data;
+
+    swap(buffer1, buffer2);
+    EXPECT_EQ(buffer1.data, buffer2_data);
+    EXPECT_TRUE(buffer2.is_inline());
+    EXPECT_EQ(buffer2[0], 1);
+
+    small_buffer<int, 2> buffer3 = { 5, 6, 7 };
+    int* buffer3_data = buffer3.data;
+    swap(buffer1, buffer3);
+    EXPECT_EQ(buffer1.data, buffer3_data);
+    EXPECT_EQ(buffer3.data, buffer2_data);
+};
+
+TEST(SmallBuffer, Resize)
+{
+    small_buffer<std::string, 2> buffer = { "a" };
+    buffer.resize(2, "b");
+    EXPECT_TRUE(buffer.is_inline());
+    EXPECT_EQ(buffer[1], "b");
+
+    buffer.resize(4, buffer[0]);
+    EXPECT_FALSE(buffer.is_inline());
+    EXPECT_EQ(buffer[1], "b");
+    EXPECT_EQ(buffer[3], "a");
+
+    std::string* buffer_data = buffer.data;
+    buffer.resize(1);
+    EXPECT_EQ(buffer.data, buffer_data);
+    buffer.shrink_to_fit();
+    EXPECT_TRUE(buffer.is_inline());
+    EXPECT_EQ(buffer[0], "a");
+
+    buffer.resize(3);
+    buffer.resize(0);
+    EXPECT_TRUE(buffer.is_inline());
+    EXPECT_EQ(buffer.size, 0);
+};
+
+TEST(SmallBuffer, ResizeUninitialized)
+{
+    small_buffer<int, 2> buffer = { 1, 2 };
+    buffer.resize(uninitialized, 5);
+    EXPECT_FALSE(buffer.is_inline());
+    EXPECT_EQ(buffer[0], 1);
+    EXPECT_EQ(buffer[1], 2);
+};
+
+TEST(SmallBuffer, Iterators)
+{
+    static_assert(std::contiguous_iterator<small_buffer_iterator<int, 4>>);
+    small_buffer<int, 4> buffer = { 0, 1, 2, 3, 4, 5 };
+
+    std::size_t index = 0;
+    for (auto& value : buffer)
+    {
+        EXPECT_EQ(value, index);
+        ++index;
+    }
+    for (auto itr = buffer.crbegin(); itr != buffer.crend(); ++itr)
+    {
+        --index;
+        EXPECT_EQ(*itr, index);
+    }
+};
+
+TEST(SmallBuffer, Comparison)
+{
+    small_buffer<int, 4> buffer1 = { 0, 1, 2 };
+    small_buffer<int, 4> buffer2 = { 0, 1, 2, 3, 4 };
+
+    EXPECT_NE(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+    buffer2.resize(3);
+    EXPECT_EQ(buffer1, buffer2);
+};
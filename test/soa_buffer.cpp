@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <string>
+#include "containers/soa_buffer.hpp"
+
+static_assert(std::random_access_iterator<soa_buffer<int, float>::iterator>);
+static_assert(std::random_access_iterator<soa_buffer<int, float>::const_iterator>);
+static_assert(std::ranges::random_access_range<soa_buffer<int, float>>);
+
+TEST(SoaBuffer, Construction)
+{
+    soa_buffer<int, double, std::string> empty{};
+    EXPECT_EQ(empty.size, 0);
+    EXPECT_EQ(empty.data, nullptr);
+
+    soa_buffer<int, double, std::string> rows{ 3, 7, 0.5, "row" };
+    EXPECT_EQ(rows.size, 3);
+    for (std::size_t i = 0; i < rows.size; ++i)
+    {
+        EXPECT_EQ(rows[i], std::tuple(7, 0.5, std::string{ "row" }));
+    }
+
+    soa_buffer<int, double> zeros(4);
+    EXPECT_EQ(zeros.size, 4);
+    EXPECT_TRUE(std::ranges::all_of(zeros.column<0>(), [](int value) { return value == 0; }));
+    EXPECT_TRUE(std::ranges::all_of(zeros.column<1>(), [](double value) { return value == 0.0; }));
+};
+
+TEST(SoaBuffer, ColumnLayout)
+{
+    soa_buffer<char, double, std::uint16_t> rows{ 13, 'a', 1.0, 2 };
+
+    // one allocation, every column on its own aligned run.
+    EXPECT_EQ(static_cast<void*>(std::get<0>(rows.columns)), static_cast<void*>(rows.data));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.column<1>().data()) % decltype(rows)::column_alignment, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.column<2>().data()) % decltype(rows)::column_alignment, 0);
+    EXPECT_GE(reinterpret_cast<std::byte*>(rows.column<1>().data()), reinterpret_cast<std::byte*>(rows.column<0>().data() + 13));
+    EXPECT_GE(reinterpret_cast<std::byte*>(rows.column<2>().data()), reinterpret_cast<std::byte*>(rows.column<1>().data() + 13));
+    EXPECT_EQ(decltype(rows)::column_offsets(13), (std::array<std::size_t, 4>{ 0, 64, 192, 256 }));
+
+    EXPECT_EQ(rows.column<1>().size(), 13);
+    EXPECT_EQ(std::reduce(rows.column<1>().begin(), rows.column<1>().end()), 13.0);
+};
+
+TEST(SoaBuffer, RowAccess)
+{
+    soa_buffer<int, std::string> rows(3);
+    rows[0] = std::tuple(1, "one");
+    std::get<0>(rows[1]) = 2;
+    std::get<1>(rows[1]) = "two";
+    auto [number, name] = rows[2];
+    number = 3;
+    name = "three";
+
+    EXPECT_EQ(rows.column<0>()[0], 1);
+    EXPECT_EQ(rows.column<0>()[1], 2);
+    EXPECT_EQ(rows.column<0>()[2], 3);
+    EXPECT_EQ(rows.column<1>()[2], "three");
+
+    const auto& view = rows;
+    EXPECT_EQ(view[1], std::tuple(2, std::string{ "two" }));
+};
+
+TEST(SoaBuffer, Iteration)
+{
+    soa_buffer<int, int> rows(5);
+    int i = 0;
+    for (auto [key, value] : rows)
+    {
+        key = i;
+        value = i * i;
+        ++i;
+    }
+
+    EXPECT_EQ(rows.end() - rows.begin(), 5);
+    EXPECT_EQ(std::get<1>(rows.begin()[3]), 9);
+    EXPECT_EQ(std::get<0>(*std::prev(rows.end())), 4);
+    EXPECT_EQ(std::get<0>(*rows.rbegin()), 4);
+
+    std::tuple<int, int> total{ 0, 0 };
+    for (const auto& [key, value] : std::as_const(rows))
+    {
+        std::get<0>(total) += key;
+        std::get<1>(total) += value;
+    }
+    EXPECT_EQ(total, std::tuple(10, 30));
+
+    const auto found = std::find_if(rows.cbegin(), rows.cend(), [](const auto& row) { return std::get<1>(row) == 16; });
+    EXPECT_EQ(found - rows.cbegin(), 4);
+    EXPECT_EQ(std::ranges::count_if(rows, [](const auto& row) { return std::get<0>(row) % 2 == 0; }), 3);
+};
+
+TEST(SoaBuffer, Resize)
+{
+    soa_buffer<int, std::string> rows{ 2, 1, "a" };
+
+    rows.resize(5, 2, "b");
+    EXPECT_EQ(rows.size, 5);
+    EXPECT_EQ(rows.capacity, 5);
+    EXPECT_EQ(rows[1], std::tuple(1, std::string{ "a" }));
+    EXPECT_EQ(rows[4], std::tuple(2, std::string{ "b" }));
+
+    rows.resize(1);
+    EXPECT_EQ(rows.size, 1);
+    EXPECT_EQ(rows.capacity, 5);
+    EXPECT_EQ(rows[0], std::tuple(1, std::string{ "a" }));
+
+    rows.resize(3);
+    EXPECT_EQ(rows.capacity, 5);
+    EXPECT_EQ(rows[2], std::tuple(0, std::string{}));
+};
+
+TEST(SoaBuffer, ResizeMoveOnly)
+{
+    soa_buffer<int, std::unique_ptr<int>> rows(1);
+    std::get<1>(rows[0]) = std::make_unique<int>(5);
+
+    rows.resize(4);
+    EXPECT_EQ(*std::get<1>(rows[0]), 5);
+    EXPECT_EQ(std::get<1>(rows[3]), nullptr);
+    rows.resize(2);
+    EXPECT_EQ(rows.size, 2);
+};
+
+TEST(SoaBuffer, AnyAllocatorAligns)
+{
+    basic_soa_buffer<std::allocator<std::byte>, char, double> rows{ 3, 'a', 1.0 };
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.data) % decltype(rows)::column_alignment, 0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(rows.column<1>().data()) % decltype(rows)::column_alignment, 0);
+
+    // a one byte allocation first leaves the resource off any useful alignment.
+    std::pmr::monotonic_buffer_resource resource{};
+    [[maybe_unused]] std::byte* offset = std::pmr::polymorphic_allocator<std::byte>{ &resource }.allocate(1);
+    basic_soa_buffer<std::pmr::polymorphic_allocator<std::byte>, char, double> pmr_rows{ &resource };
+    pmr_rows.resize(3, 'b', 2.0);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(pmr_rows.data) % decltype(pmr_rows)::column_alignment, 0);
+    EXPECT_EQ(pmr_rows[2], std::tuple('b', 2.0));
+};
+
+struct fragile
+{
+    static inline int live = 0;
+    static inline int fail_at = -1;
+
+    fragile()
+    {
+        if (live == fail_at)
+        {
+            throw std::runtime_error{ "fragile" };
+        }
+        ++live;
+    };
+    fragile(const fragile&) : fragile{} {};
+    fragile(fragile&&) noexcept { ++live; };
+    ~fragile() { --live; };
+};
+
+TEST(SoaBuffer, ResizeFailure)
+{
+    {
+        soa_buffer<std::string, fragile> rows{ 2, "kept", fragile{} };
+        fragile::fail_at = 4;
+        EXPECT_THROW(rows.resize(8), std::runtime_error);
+        EXPECT_EQ(rows.size, 2);
+        EXPECT_EQ(rows.capacity, 2);
+        EXPECT_EQ(rows.column<0>()[1], "kept");
+        EXPECT_EQ(fragile::live, 2);
+
+        fragile::fail_at = -1;
+        rows.resize(8);
+        EXPECT_EQ(fragile::live, 8);
+    }
+    EXPECT_EQ(fragile::live, 0);
+};
+
+TEST(SoaBuffer, CopyAndMove)
+{
+    soa_buffer<int, std::string> rows{ 3, 4, "four" };
+
+    soa_buffer<int, std::string> copy{ rows };
+    EXPECT_EQ(copy, rows);
+    std::get<1>(copy[0]) = "changed";
+    EXPECT_FALSE(copy == rows);
+
+    soa_buffer<int, std::string> moved{ std::move(copy) };
+    EXPECT_EQ(moved.size, 3);
+    EXPECT_EQ(copy.size, 0);
+    EXPECT_EQ(copy.data, nullptr);
+
+    rows = moved;
+    EXPECT_EQ(rows, moved);
+};
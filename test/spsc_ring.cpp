@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include "containers/spsc_ring.hpp"
+
+TEST(SpscRing, Capacity)
+{
+    EXPECT_EQ(spsc_ring<int>{ 1 }.capacity, 1);
+    EXPECT_EQ(spsc_ring<int>{ 5 }.capacity, 8);
+    EXPECT_EQ(spsc_ring<int>{ 64 }.capacity, 64);
+
+    spsc_ring<int> ring{ 4 };
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&ring.tail) / spsc_ring<int>::cache_line,
+        reinterpret_cast<std::uintptr_t>(&ring.cached_head) / spsc_ring<int>::cache_line);
+    EXPECT_NE(reinterpret_cast<std::uintptr_t>(&ring.tail) / spsc_ring<int>::cache_line,
+        reinterpret_cast<std::uintptr_t>(&ring.head) / spsc_ring<int>::cache_line);
+};
+
+TEST(SpscRing, PushAndPop)
+{
+    spsc_ring<int> ring{ 4 };
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.try_push(i));
+    }
+    EXPECT_FALSE(ring.try_push(4));
+    EXPECT_EQ(ring.size(), 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.try_pop(value));
+        EXPECT_EQ(value, i);
+    }
+    EXPECT_FALSE(ring.try_pop(value));
+    EXPECT_TRUE(ring.empty());
+};
+
+TEST(SpscRing, Spans)
+{
+    spsc_ring<int> ring{ 8 };
+    for (int i = 0; i < 6; ++i)
+    {
+        ring.try_push(i);
+    }
+    int value = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        ring.try_pop(value);
+    }
+
+    // tail sits at slot 6, head at slot 5, so the free run stops at the end of the storage.
+    auto free = ring.writable();
+    EXPECT_EQ(free.size(), 2);
+    free[0] = 6;
+    free[1] = 7;
+    ring.commit_write(2);
+
+    free = ring.writable();
+    EXPECT_EQ(free.size(), 5);
+    free[0] = 8;
+    ring.commit_write(1);
+
+    auto filled = ring.readable();
+    EXPECT_EQ(filled.size(), 3);
+    EXPECT_EQ(filled[0], 5);
+    EXPECT_EQ(filled[2], 7);
+    ring.commit_read(3);
+
+    filled = ring.readable();
+    EXPECT_EQ(filled.size(), 1);
+    EXPECT_EQ(filled[0], 8);
+    ring.commit_read(1);
+    EXPECT_TRUE(ring.empty());
+};
+
+TEST(SpscRing, Batches)
+{
+    spsc_ring<int> ring{ 8 };
+    const int input[] = { 1, 2, 3, 4, 5, 6 };
+    int output[6] = {};
+
+    EXPECT_EQ(ring.push(input), 6);
+    EXPECT_EQ(ring.pop(std::span{ output, 4 }), 4);
+    EXPECT_EQ(ring.push(input), 6);
+    EXPECT_EQ(ring.push(input), 0);
+
+    EXPECT_EQ(ring.pop(output), 6);
+    EXPECT_EQ(output[0], 5);
+    EXPECT_EQ(output[1], 6);
+    EXPECT_EQ(output[2], 1);
+    EXPECT_EQ(output[5], 4);
+};
+
+TEST(SpscRing, NonTrivialElements)
+{
+    auto shared = std::make_shared<int>(1);
+    {
+        spsc_ring<std::shared_ptr<int>> ring{ 4 };
+        ring.try_push(shared);
+        ring.try_push(shared);
+        ring.try_push(shared);
+        EXPECT_EQ(shared.use_count(), 4);
+
+        std::shared_ptr<int> value{};
+        ring.try_pop(value);
+        EXPECT_EQ(shared.use_count(), 4);
+        value.reset();
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    EXPECT_EQ(shared.use_count(), 1);
+
+    spsc_ring<std::string> strings{ 2 };
+    strings.try_push(20, 'a');
+    std::string value{};
+    strings.try_pop(value);
+    EXPECT_EQ(value, std::string(20, 'a'));
+};
+
+TEST(SpscRing, Concurrent)
+{
+    constexpr std::uint64_t count = 200'000;
+    spsc_ring<std::uint64_t> ring{ 1024 };
+
+    std::thread producer{ [&]
+    {
+        for (std::uint64_t i = 0; i < count;)
+        {
+            if (i % 3 == 0)
+            {
+                auto free = ring.writable();
+                std::size_t written = 0;
+                for (; written < free.size() and i < count; ++written, ++i)
+                {
+                    free[written] = i;
+                }
+                ring.commit_write(written);
+            }
+            else if (ring.try_push(i))
+            {
+                ++i;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    } };
+
+    std::uint64_t expected = 0;
+    bool ordered = true;
+    while (expected < count)
+    {
+        std::uint64_t batch[64];
+        const std::size_t popped = ring.pop(batch);
+        if (popped == 0)
+        {
+            std::this_thread::yield();
+        }
+        for (std::size_t j = 0; j < popped; ++j)
+        {
+            ordered = ordered and batch[j] == expected++;
+        }
+    }
+    producer.join();
+
+    EXPECT_TRUE(ordered);
+    EXPECT_TRUE(ring.empty());
+};
@@ -0,0 +1,201 @@
+#include <gtest/gtest.h>
+#include <string>
+#include "containers/static_buffer.hpp"
+
+TEST(StaticBuffer, DefaultConstruction)
+{
+    static_assert(std::is_default_constructible_v<static_buffer<int, 4>>);
+    static_buffer<int, 4> buffer{};
+
+    EXPECT_EQ(buffer.size, 4);
+    EXPECT_NE(buffer.data, nullptr);
+
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        EXPECT_EQ(buffer.data[i], 0);
+    }
+};
+
+TEST(StaticBuffer, InitializerListConstruction)
+{
+    static_buffer<int, 6> buffer = { 0, 1, 2, 3, 4, 5 };
+
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        EXPECT_EQ(buffer.data[i], i);
+    }
+};
+
+TEST(StaticBuffer, ArgumentsConstruction)
+{
+    static_assert(std::is_constructible_v<static_buffer<int, 3>, int>);
+    static_buffer<std::string, 3> buffer("abc");
+
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        EXPECT_EQ(buffer[i], "abc");
+    }
+};
+
+TEST(StaticBuffer, CopyConstruction)
+{
+    static_buffer<std::string, 3> buffer1 = { "a", "b", "c" };
+    static_buffer<std::string, 3> buffer2{ buffer1 };
+
+    EXPECT_NE(buffer2.data, buffer1.data);
+    EXPECT_EQ(buffer2, buffer1);
+};
+
+TEST(StaticBuffer, MoveConstruction)
+{
+    static_buffer<int, 3> buffer1 = { 1, 2, 3 };
+    int* buffer1_data = buffer1.data;
+    static_buffer<int, 3> buffer2{ std::move(buffer1) };
+
+    EXPECT_EQ(buffer1.data, nullptr);
+    EXPECT_EQ(buffer2.data, buffer1_data);
+};
+
+TEST(StaticBuffer, Assignment)
+{
+    static_buffer<int, 3> buffer1 = { 1, 2, 3 };
+    static_buffer<int, 3> buffer2{};
+    buffer2 = buffer1;
+    EXPECT_EQ(buffer2, buffer1);
+    EXPECT_NE(buffer2.data, buffer1.data);
+
+    int* buffer1_data = buffer1.data;
+    static_buffer<int, 3> buffer3{};
+    buffer3 = std::move(buffer1);
+    EXPECT_EQ(buffer3.data, buffer1_data);
+};
+
+TEST(StaticBuffer, Get)
+{
+    static_buffer<int, 3> buffer = { 1, 2, 3 };
+    static_assert(requires { buffer.get<2>(); });
+
+    EXPECT_EQ(buffer.get<0>(), 1);
+    EXPECT_EQ(buffer.get<2>(), 3);
+    buffer.get<1>() = 20;
+    EXPECT_EQ(buffer[1], 20);
+};
+
+TEST(StaticBuffer, Comparison)
+{
+    static_buffer<int, 4> buffer1 = { 0, 1, 2, 3 };
+    static_buffer<int, 4> buffer2 = { 0, 1, 2, 3 };
+    static_buffer<int, 4> buffer3 = { 0, 1, 3, 3 };
+
+    EXPECT_EQ(buffer1, buffer2);
+    EXPECT_NE(buffer1, buffer3);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::equivalent);
+    EXPECT_EQ(buffer1 <=> buffer3, std::partial_ordering::less);
+    EXPECT_EQ(buffer3 <=> buffer1, std::partial_ordering::greater);
+};
+
+TEST(StaticBuffer, Swap)
+{
+    static_buffer<int, 2> buffer1 = { 1, 2 };
+    static_buffer<int, 2> buffer2 = { 3, 4 };
+    int* buffer1_data = buffer1.data;
+    int* buffer2_data = buffer2.data;
+
+    swap(buffer1, buffer2);
+    EXPECT_EQ(buffer1.data, buffer2_data);
+    EXPECT_EQ(buffer2.data, buffer1_data);
+};
+
+TEST(StaticBuffer, Iterators)
+{
+    static_assert(std::contiguous_iterator<static_buffer_iterator<int, 4>>);
+    static_assert(std::contiguous_iterator<static_buffer_const_iterator<int, 4>>);
+    static_buffer<int, 5> buffer = { 0, 1, 2, 3, 4 };
+
+    std::size_t index = 0;
+    for (auto& value : buffer)
+    {
+        EXPECT_EQ(value, index);
+        ++index;
+    }
+    for (auto itr = buffer.rbegin(); itr != buffer.rend(); ++itr)
+    {
+        --index;
+        EXPECT_EQ(*itr, index);
+    }
+};
+
+TEST(InlineBuffer, Layout)
+{
+    static_assert(sizeof(inline_buffer<int, 4>) == sizeof(int) * 4);
+    static_assert(std::is_trivially_copyable_v<inline_buffer<int, 4>>);
+    static_assert(std::contiguous_iterator<static_buffer_iterator<int, 4, inline_storage>>);
+};
+
+TEST(InlineBuffer, Construction)
+{
+    inline_buffer<int, 4> buffer1{};
+    inline_buffer<int, 4> buffer2 = { 1, 2, 3, 4 };
+    inline_buffer<int, 4> buffer3(7);
+
+    for (std::size_t i = 0; i < buffer1.size; ++i)
+    {
+        EXPECT_EQ(buffer1[i], 0);
+        EXPECT_EQ(buffer2[i], i + 1);
+        EXPECT_EQ(buffer3[i], 7);
+    }
+
+    inline_buffer<std::string, 2> buffer4("abc");
+    inline_buffer<std::string, 2> buffer5{ buffer4 };
+    EXPECT_EQ(buffer5[1], "abc");
+};
+
+TEST(InlineBuffer, InPlaceConstruction)
+{
+    struct pinned
+    {
+        int value;
+        constexpr explicit pinned(int value) : value{ value } {};
+        pinned(const pinned&) = delete;
+        auto operator =(const pinned&) -> pinned& = delete;
+    };
+    static_assert(not std::is_default_constructible_v<pinned>);
+    inline_buffer<pinned, 3> pinned_buffer(4);
+    EXPECT_EQ(pinned_buffer[2].value, 4);
+
+    std::string long_string(64, 'x');
+    inline_buffer<std::string, 3> buffer(std::move(long_string));
+    for (std::size_t i = 0; i < buffer.size; ++i)
+    {
+        EXPECT_EQ(buffer[i], std::string(64, 'x'));
+    }
+};
+
+TEST(InlineBuffer, Constexpr)
+{
+    constexpr auto sum = []
+    {
+        inline_buffer<int, 4> buffer(3);
+        buffer.get<0>() = 5;
+        int total = 0;
+        for (int value : buffer)
+        {
+            total += value;
+        }
+        return total + buffer.get<3>();
+    }();
+    static_assert(sum == 17);
+};
+
+TEST(InlineBuffer, ComparisonAndSwap)
+{
+    inline_buffer<int, 3> buffer1 = { 1, 2, 3 };
+    inline_buffer<int, 3> buffer2 = { 1, 2, 4 };
+
+    EXPECT_NE(buffer1, buffer2);
+    EXPECT_EQ(buffer1 <=> buffer2, std::partial_ordering::less);
+
+    swap(buffer1, buffer2);
+    EXPECT_EQ(buffer1[2], 4);
+    EXPECT_EQ(buffer2[2], 3);
+};